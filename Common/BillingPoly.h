@@ -0,0 +1,284 @@
+// Billing engine shared by LabAssignment2.cpp and Assignment2.cpp: the
+// canonical billing polynomial with checked sparse-Horner evaluation and a
+// batch kernel, and the product kernels (Karatsuba for dense bills, a hash
+// accumulator for everything else) over (coeff, exp) term vectors.
+#ifndef COMMON_BILLING_POLY_H
+#define COMMON_BILLING_POLY_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#if defined(__x86_64__) || defined(__i386__)
+#define BILLING_X86
+#include <immintrin.h>
+#endif
+
+#ifdef BILLING_X86
+// The batch kernel is compiled for AVX2 and only called when the CPU has
+// it, so the default build needs no extra flags.
+#define BILLING_AVX2 __attribute__((target("avx2")))
+#endif
+
+typedef std::vector<std::pair<long long, int>> BillTerms;  // (coeff, exp)
+
+// Evaluation engine for billing polynomials. Terms are merged and kept
+// sorted by descending exponent, then evaluated with sparse Horner steps
+//     acc = acc * x^(gap to next exponent) + coeff
+// where x^gap uses exponentiation by squaring. Scalar evaluation is exact
+// and overflow-checked (128-bit intermediates, 64-bit result). The power
+// is skipped while acc is 0, so terms that cancel (2x^200 - 4x^199 at
+// x = 2) do not report a spurious overflow.
+class BillingPoly {
+    std::vector<long long> coeffs;
+    std::vector<int> exps;   // strictly descending, coeffs all nonzero
+
+    static bool mulChecked(__int128 a, __int128 b, __int128& out) {
+        return !__builtin_mul_overflow(a, b, &out);
+    }
+
+    static bool powChecked(__int128 x, int e, __int128& out) {
+        __int128 result = 1;
+        while (e > 0) {
+            if ((e & 1) && !mulChecked(result, x, result)) return false;
+            e >>= 1;
+            if (e > 0 && !mulChecked(x, x, x)) return false;
+        }
+        out = result;
+        return true;
+    }
+
+#ifdef BILLING_X86
+    // Four x values per lane group in double precision; a lane whose
+    // intermediates all stay below 2^53 is exact, any other lane is redone
+    // with the checked scalar path. Returns how many inputs it covered.
+    BILLING_AVX2 size_t evaluateBatchAvx2(const std::vector<long long>& xs, std::vector<long long>& out,
+                                          std::vector<char>& overflow, size_t& bad) const {
+        size_t n = xs.size(), i = 0;
+        size_t simdEnd = n - n % 4;
+        for (long long c : coeffs)
+            if (std::llabs(c) >= (1LL << 53)) return 0;  // not exact as doubles
+        const __m256d exact = _mm256_set1_pd(9007199254740992.0);  // 2^53
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        for (; i < simdEnd; i += 4) {
+            __m256d x = _mm256_setr_pd((double)xs[i], (double)xs[i + 1], (double)xs[i + 2], (double)xs[i + 3]);
+            __m256d acc = _mm256_setzero_pd();
+            __m256d peak = _mm256_andnot_pd(signMask, x);
+            for (size_t k = 0; k <= coeffs.size(); k++) {
+                int gap = k == 0 ? 0 : (k < coeffs.size() ? exps[k - 1] - exps[k] : exps.back());
+                if (gap > 0) {
+                    // x^gap by squaring; the same exponent bits drive every lane
+                    __m256d pw = _mm256_set1_pd(1.0), base = x;
+                    while (true) {
+                        if (gap & 1) pw = _mm256_mul_pd(pw, base);
+                        gap >>= 1;
+                        if (gap == 0) break;
+                        base = _mm256_mul_pd(base, base);
+                    }
+                    acc = _mm256_mul_pd(acc, pw);
+                    peak = _mm256_max_pd(peak, _mm256_andnot_pd(signMask, pw));
+                    peak = _mm256_max_pd(peak, _mm256_andnot_pd(signMask, acc));
+                }
+                if (k < coeffs.size()) {
+                    acc = _mm256_add_pd(acc, _mm256_set1_pd((double)coeffs[k]));
+                    peak = _mm256_max_pd(peak, _mm256_andnot_pd(signMask, acc));
+                }
+            }
+            double lane[4];
+            _mm256_storeu_pd(lane, acc);
+            int inexact = _mm256_movemask_pd(_mm256_cmp_pd(peak, exact, _CMP_NLT_UQ));
+            for (int l = 0; l < 4; l++) {
+                if (!(inexact >> l & 1)) out[i + l] = (long long)lane[l];
+                else if (!evaluate(xs[i + l], out[i + l])) {
+                    overflow[i + l] = 1;
+                    bad++;
+                }
+            }
+        }
+        return i;
+    }
+#endif
+
+public:
+    // Builds the canonical form from (coeff, exp) terms in any order.
+    // Negative exponents are not valid in a billing polynomial and are skipped.
+    static BillingPoly fromTerms(BillTerms terms) {
+        std::sort(terms.begin(), terms.end(), [](const std::pair<long long, int>& a, const std::pair<long long, int>& b) {
+            return a.second > b.second;
+        });
+        BillingPoly p;
+        for (auto &t : terms) {
+            if (t.second < 0) continue;
+            if (!p.exps.empty() && p.exps.back() == t.second) p.coeffs.back() += t.first;
+            else {
+                p.coeffs.push_back(t.first);
+                p.exps.push_back(t.second);
+            }
+            if (p.coeffs.back() == 0) {
+                p.coeffs.pop_back();
+                p.exps.pop_back();
+            }
+        }
+        return p;
+    }
+
+    size_t terms() const { return coeffs.size(); }
+
+    // Returns false if the value does not fit in 64 bits.
+    bool evaluate(long long x, long long& out) const {
+        __int128 acc = 0, step;
+        for (size_t i = 0; i < coeffs.size(); i++) {
+            if (i > 0 && acc != 0) {
+                if (!powChecked(x, exps[i - 1] - exps[i], step) || !mulChecked(acc, step, acc))
+                    return false;
+            }
+            acc += coeffs[i];
+        }
+        if (!coeffs.empty() && acc != 0) {
+            if (!powChecked(x, exps.back(), step) || !mulChecked(acc, step, acc)) return false;
+        }
+        if (acc > INT64_MAX || acc < INT64_MIN) return false;
+        out = (long long)acc;
+        return true;
+    }
+
+    // Evaluates the polynomial at every xs[i], four at a time on CPUs with
+    // AVX2. overflow[i] is set when the value does not fit in 64 bits.
+    // Returns the number of overflowing inputs.
+    size_t evaluateBatch(const std::vector<long long>& xs, std::vector<long long>& out,
+                         std::vector<char>& overflow) const {
+        size_t n = xs.size();
+        out.assign(n, 0);
+        overflow.assign(n, 0);
+        size_t i = 0, bad = 0;
+#ifdef BILLING_X86
+        if (__builtin_cpu_supports("avx2")) i = evaluateBatchAvx2(xs, out, overflow, bad);
+#endif
+        for (; i < n; i++) {
+            if (!evaluate(xs[i], out[i])) {
+                overflow[i] = 1;
+                bad++;
+            }
+        }
+        return bad;
+    }
+};
+
+// ------------------------------------------------------------
+// Products of bills
+// ------------------------------------------------------------
+// Karatsuba product of two equal-length dense coefficient vectors
+// (index = exponent), modulo 2^64. Returns 2n - 1 coefficients. Wrapped
+// intermediates cancel out, so a coefficient is exact whenever its true
+// value fits in 64 bits; multiplyTerms only calls this when a bound on
+// the coefficients guarantees that.
+inline std::vector<unsigned long long> karatsuba(const std::vector<unsigned long long>& a,
+                                                 const std::vector<unsigned long long>& b) {
+    size_t n = a.size();
+    std::vector<unsigned long long> out(2 * n - 1, 0);
+    if (n <= 32) {
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = 0; j < n; j++) out[i + j] += a[i] * b[j];
+        return out;
+    }
+    size_t m = n / 2, h = n - m;
+    std::vector<unsigned long long> a0(a.begin(), a.begin() + m), a1(a.begin() + m, a.end());
+    std::vector<unsigned long long> b0(b.begin(), b.begin() + m), b1(b.begin() + m, b.end());
+    a0.resize(h, 0);
+    b0.resize(h, 0);
+
+    std::vector<unsigned long long> z0 = karatsuba(a0, b0);
+    std::vector<unsigned long long> z2 = karatsuba(a1, b1);
+    for (size_t i = 0; i < h; i++) {
+        a0[i] += a1[i];
+        b0[i] += b1[i];
+    }
+    std::vector<unsigned long long> z1 = karatsuba(a0, b0);
+
+    for (size_t i = 0; i < z1.size(); i++) z1[i] -= z0[i] + z2[i];
+    for (size_t i = 0; i < z0.size() && i < out.size(); i++) out[i] += z0[i];
+    for (size_t i = 0; i < z1.size() && i + m < out.size(); i++) out[i + m] += z1[i];
+    for (size_t i = 0; i < z2.size() && i + 2 * m < out.size(); i++) out[i + 2 * m] += z2[i];
+    return out;
+}
+
+// Largest possible |coefficient| of a * b: every output coefficient is at
+// most min(sum|a| * max|b|, max|a| * sum|b|). Saturates at 2^127 - 1.
+inline __int128 productBound(const BillTerms& ta, const BillTerms& tb) {
+    const __int128 cap = ~((unsigned __int128)1 << 127);
+    __int128 sumA = 0, sumB = 0, maxA = 0, maxB = 0, x, y;
+    for (auto &t : ta) {
+        __int128 v = t.first < 0 ? -(__int128)t.first : t.first;
+        sumA += v;
+        maxA = std::max(maxA, v);
+    }
+    for (auto &t : tb) {
+        __int128 v = t.first < 0 ? -(__int128)t.first : t.first;
+        sumB += v;
+        maxB = std::max(maxB, v);
+    }
+    if (__builtin_mul_overflow(sumA, maxB, &x)) x = cap;
+    if (__builtin_mul_overflow(maxA, sumB, &y)) y = cap;
+    return std::min(x, y);
+}
+
+// The two product paths below take canonical operands (nonempty, exponents
+// strictly descending) and emit the nonzero product terms in no particular
+// order.
+
+// Karatsuba over the dense coefficient vectors. Exact only when
+// productBound(ta, tb) fits in 64 bits.
+inline void multiplyDense(const BillTerms& ta, const BillTerms& tb, BillTerms& product) {
+    int lowA = ta.back().second, lowB = tb.back().second;
+    size_t range = std::max(ta.front().second - lowA, tb.front().second - lowB) + 1;
+    std::vector<unsigned long long> ca(range, 0), cb(range, 0);
+    for (auto &t : ta) ca[t.second - lowA] = t.first;
+    for (auto &t : tb) cb[t.second - lowB] = t.first;
+    std::vector<unsigned long long> cp = karatsuba(ca, cb);
+    product.clear();
+    for (size_t i = 0; i < cp.size(); i++)
+        if (cp[i] != 0) product.push_back({(long long)cp[i], (int)i + lowA + lowB});
+}
+
+// Exact 128-bit partial products accumulated in a hash map keyed by
+// exponent. Returns false if a coefficient does not fit in 64 bits (or a
+// partial sum leaves 128 bits).
+inline bool multiplySparse(const BillTerms& ta, const BillTerms& tb, BillTerms& product) {
+    size_t rangeA = ta.front().second - ta.back().second + 1;
+    size_t rangeB = tb.front().second - tb.back().second + 1;
+    std::unordered_map<int, __int128> acc;
+    acc.reserve(std::min(ta.size() * tb.size(), rangeA + rangeB));
+    for (auto &x : ta)
+        for (auto &y : tb) {
+            __int128& slot = acc[x.second + y.second];
+            if (__builtin_add_overflow(slot, (__int128)x.first * y.first, &slot)) return false;
+        }
+    product.clear();
+    for (auto &kv : acc) {
+        if (kv.second > INT64_MAX || kv.second < INT64_MIN) return false;
+        if (kv.second != 0) product.push_back({(long long)kv.second, kv.first});
+    }
+    return true;
+}
+
+// product = a * b. Dense operands (at least 64 terms each, and at least
+// half of each exponent range populated) whose coefficient bound fits in
+// 64 bits go through Karatsuba; everything else through the hash map.
+// Returns false if a coefficient of the product does not fit in 64 bits.
+inline bool multiplyTerms(const BillTerms& ta, const BillTerms& tb, BillTerms& product) {
+    if (ta.empty() || tb.empty()) {
+        product.clear();
+        return true;
+    }
+    size_t rangeA = ta.front().second - ta.back().second + 1;
+    size_t rangeB = tb.front().second - tb.back().second + 1;
+    bool dense = std::min(ta.size(), tb.size()) >= 64 && ta.size() * 2 >= rangeA && tb.size() * 2 >= rangeB &&
+                 productBound(ta, tb) <= INT64_MAX;
+    if (!dense) return multiplySparse(ta, tb, product);
+    multiplyDense(ta, tb, product);
+    return true;
+}
+
+#endif
@@ -0,0 +1,305 @@
+// Graph engine shared by LabAssignment4.cpp and Assignment4.cpp: a
+// growable edge builder frozen into compressed sparse rows, the dense
+// matrix view built from it on demand, and Dijkstra / A* over the CSR
+// form with a radix heap.
+#ifndef COMMON_GRAPH_ENGINE_H
+#define COMMON_GRAPH_ENGINE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+// Distance of an unreachable node, and the weight of a missing edge.
+const int INF = 1e9;
+
+/*---------------------------------------------
+    GRAPH STORAGE (BUILDER -> CSR)
+----------------------------------------------*/
+// Edges are collected in a growable builder and frozen into compressed
+// sparse row form: the out-edges of u are targets[offsets[u]] up to
+// targets[offsets[u + 1] - 1], with matching weights. Memory is O(n + m)
+// instead of O(n^2). Node IDs are 1-based, so offsets has n + 2 entries.
+struct GraphBuilder
+{
+    struct Edge
+    {
+        int u, v, w;
+    };
+
+    int n = 0;
+    std::vector<Edge> edges;                             // directed, in insertion order
+    std::vector<float> x = std::vector<float>(1), y = x; // node coordinates, 1-based
+
+    int addNode(float px = 0, float py = 0)
+    {
+        x.push_back(px);
+        y.push_back(py);
+        return ++n;
+    }
+
+    void addEdge(int u, int v, int w)
+    {
+        edges.push_back({u, v, w});
+    }
+};
+
+struct CsrGraph
+{
+    int n = 0;
+    std::vector<int> offsets;
+    std::vector<int> targets, weights;
+    std::vector<float> x, y;
+
+    int edgeCount() const
+    {
+        return (int)targets.size();
+    }
+};
+
+// Counting sort of the edges by source. Each node's out-edges keep their
+// insertion order, matching the old adjacency lists.
+inline CsrGraph freeze(const GraphBuilder &b)
+{
+    CsrGraph g;
+    g.n = b.n;
+    g.x = b.x;
+    g.y = b.y;
+    g.offsets.assign(b.n + 2, 0);
+    for (auto &e : b.edges)
+        g.offsets[e.u + 1]++;
+    for (int u = 1; u <= b.n + 1; u++)
+        g.offsets[u] += g.offsets[u - 1];
+
+    g.targets.resize(b.edges.size());
+    g.weights.resize(b.edges.size());
+    std::vector<int> next(g.offsets.begin(), g.offsets.end() - 1);
+    for (auto &e : b.edges)
+    {
+        int at = next[e.u]++;
+        g.targets[at] = e.v;
+        g.weights[at] = e.w;
+    }
+    return g;
+}
+
+// Dense matrices are only built for graphs up to this many nodes.
+const int MATRIX_MAX_NODES = 2048;
+
+// Row-major (n + 1) x (n + 1) matrix of edge weights, INF where there is
+// no edge and 0 on the diagonal. Parallel edges keep the lightest weight.
+inline std::vector<int> adjacencyMatrix(const CsrGraph &g)
+{
+    int stride = g.n + 1;
+    std::vector<int> mat((size_t)stride * stride, INF);
+    for (int u = 1; u <= g.n; u++)
+    {
+        mat[(size_t)u * stride + u] = 0;
+        for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
+        {
+            int &cell = mat[(size_t)u * stride + g.targets[i]];
+            cell = std::min(cell, g.weights[i]);
+        }
+    }
+    return mat;
+}
+
+/*---------------------------------------------
+    SHORTEST PATH ENGINE (RADIX HEAP)
+----------------------------------------------*/
+// Monotone priority queue for Dijkstra: keys popped never decrease, so an
+// entry only needs to be filed by the highest bit in which it differs from
+// the last popped key. Each entry moves down at most 32 buckets in total,
+// and the bucket vectors keep their capacity between queries.
+class RadixHeap
+{
+public:
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    void push(uint32_t key, int v)
+    {
+        buckets[bucketOf(key)].push_back({key, v});
+        count++;
+    }
+
+    // Smallest key; the heap must not be empty.
+    uint32_t topKey()
+    {
+        refill();
+        return last;
+    }
+
+    std::pair<uint32_t, int> pop()
+    {
+        refill();
+        std::pair<uint32_t, int> e = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return e;
+    }
+
+    void clear()
+    {
+        for (auto &b : buckets)
+            b.clear();
+        last = 0;
+        count = 0;
+    }
+
+private:
+    std::vector<std::pair<uint32_t, int>> buckets[33];
+    uint32_t last = 0;
+    size_t count = 0;
+
+    int bucketOf(uint32_t key) const
+    {
+        return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+    }
+
+    // Moves the entries with the smallest key into bucket 0.
+    void refill()
+    {
+        if (!buckets[0].empty())
+            return;
+        int i = 1;
+        while (buckets[i].empty())
+            i++;
+        last = buckets[i][0].first;
+        for (auto &e : buckets[i])
+            last = std::min(last, e.first);
+        for (auto &e : buckets[i])
+            buckets[bucketOf(e.first)].push_back(e);
+        buckets[i].clear();
+    }
+};
+
+// Heuristic of plain Dijkstra.
+struct NoHeuristic
+{
+    int operator()(int) const
+    {
+        return 0;
+    }
+};
+
+// Dijkstra over a CSR graph with non-negative weights. The distance and
+// predecessor buffers are sized once and reused: an entry is only valid if
+// its stamp equals the current query's epoch, so a query costs O(settled)
+// rather than O(n). With a target, the search stops once it is settled.
+class ShortestPaths
+{
+public:
+    int settled = 0; // nodes settled by the last query
+
+    // Dijkstra, or A* when h(v) is a consistent lower bound on the
+    // distance from v to target.
+    template <typename H = NoHeuristic>
+    void run(const CsrGraph &g, int source, int target = 0, H h = H())
+    {
+        start(g, source, h(source));
+        while (int u = settleNext(g, h))
+            if (u == target)
+                break;
+    }
+
+    // Step-by-step interface, for searches that interleave two frontiers.
+    void start(const CsrGraph &g, int source, int key = 0)
+    {
+        if ((int)stamp.size() < g.n + 1)
+        {
+            dist.resize(g.n + 1);
+            pred.resize(g.n + 1);
+            stamp.resize(g.n + 1, 0);
+        }
+        if (++epoch == 0) // wrapped: old stamps could look current
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            epoch = 1;
+        }
+        heap.clear();
+        settled = 0;
+
+        reach(source, 0, 0);
+        heap.push(key, source);
+    }
+
+    bool exhausted() const
+    {
+        return heap.empty();
+    }
+
+    // Lower bound on the key of the next node to settle.
+    uint32_t frontier()
+    {
+        return heap.topKey();
+    }
+
+    // Settles the closest unsettled node and relaxes its edges. Returns
+    // the node, or 0 once nothing is left to settle. With stall, a node
+    // that a neighbour reaches more cheaply is settled but not expanded;
+    // this never happens in a plain search but prunes searches over the
+    // upward edges of a contraction hierarchy.
+    template <typename H = NoHeuristic>
+    int settleNext(const CsrGraph &g, H h = H(), bool stall = false)
+    {
+        while (!heap.empty())
+        {
+            std::pair<uint32_t, int> top = heap.pop();
+            int u = top.second;
+            if ((int)top.first != dist[u] + h(u))
+                continue;
+            settled++;
+            if (stall)
+                for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
+                    if ((long long)distance(g.targets[i]) + g.weights[i] < dist[u])
+                        return u;
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
+            {
+                int v = g.targets[i], d = dist[u] + g.weights[i];
+                if (d < distance(v))
+                {
+                    reach(v, d, u);
+                    heap.push(d + h(v), v);
+                }
+            }
+            return u;
+        }
+        return 0;
+    }
+
+    int distance(int v) const
+    {
+        return stamp[v] == epoch ? dist[v] : INF;
+    }
+
+    // Nodes from the source to v, or empty if v was not reached.
+    std::vector<int> path(int v) const
+    {
+        std::vector<int> p;
+        if (distance(v) == INF)
+            return p;
+        for (; v != 0; v = pred[v])
+            p.push_back(v);
+        std::reverse(p.begin(), p.end());
+        return p;
+    }
+
+private:
+    std::vector<int> dist, pred;
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+    RadixHeap heap;
+
+    void reach(int v, int d, int from)
+    {
+        stamp[v] = epoch;
+        dist[v] = d;
+        pred[v] = from;
+    }
+};
+
+#endif
@@ -0,0 +1,1098 @@
+// Sorting, ranking and hashing engine shared by LabAssignment3.cpp and
+// Assignment3.cpp, plus the --bench harness both programs drive. All of
+// it is generic over the record type: keys are read through the KeyFn /
+// Less / IdFn arguments, never through a particular Student layout.
+#ifndef COMMON_SORT_ENGINE_H
+#define COMMON_SORT_ENGINE_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <array>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <climits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// -------------------------------------------------------
+// Natural merge sort
+// -------------------------------------------------------
+// Natural merge sort: the input is split into its existing ascending runs
+// (strictly descending runs are reversed), short runs are padded out to
+// MERGE_MIN_RUN with insertion sort, and runs are then merged pairwise
+// until one is left. Nearly sorted input therefore costs close to a single
+// pass. Elements are moved, never copied, and every merge shares one
+// scratch buffer of half the range. Stable.
+const int MERGE_MIN_RUN = 32;
+
+// Sorts arr[lo, hi) given that arr[lo, start) is already sorted.
+template <typename T, typename Less>
+void insertionSortRange(std::vector<T>& arr, int lo, int start, int hi, Less less) {
+    for (int i = start; i < hi; i++) {
+        T key = std::move(arr[i]);
+        int j = i;
+        while (j > lo && less(key, arr[j - 1])) {
+            arr[j] = std::move(arr[j - 1]);
+            j--;
+        }
+        arr[j] = std::move(key);
+    }
+}
+
+// Merges sorted arr[lo, mid) and arr[mid, hi), parking the shorter side in
+// scratch and filling from the far end when that side is the right one.
+template <typename T, typename Less>
+void mergeRuns(std::vector<T>& arr, int lo, int mid, int hi, std::vector<T>& scratch, Less less) {
+    if (!less(arr[mid], arr[mid - 1])) return;  // already in order
+
+    // Left elements not above arr[mid] and right elements not below
+    // arr[mid - 1] are already in their final place.
+    lo = std::upper_bound(arr.begin() + lo, arr.begin() + mid, arr[mid], less) - arr.begin();
+    hi = std::lower_bound(arr.begin() + mid, arr.begin() + hi, arr[mid - 1], less) - arr.begin();
+
+    if (mid - lo <= hi - mid) {
+        int n1 = mid - lo;
+        std::move(arr.begin() + lo, arr.begin() + mid, scratch.begin());
+        int i = 0, j = mid, k = lo;
+        while (i < n1 && j < hi)
+            arr[k++] = less(arr[j], scratch[i]) ? std::move(arr[j++]) : std::move(scratch[i++]);
+        while (i < n1) arr[k++] = std::move(scratch[i++]);
+    } else {
+        int n2 = hi - mid;
+        std::move(arr.begin() + mid, arr.begin() + hi, scratch.begin());
+        int i = mid - 1, j = n2 - 1, k = hi - 1;
+        while (i >= lo && j >= 0)
+            arr[k--] = less(scratch[j], arr[i]) ? std::move(arr[i--]) : std::move(scratch[j--]);
+        while (j >= 0) arr[k--] = std::move(scratch[j--]);
+    }
+}
+
+// Stable sort of arr[l..r] (inclusive) by less.
+template <typename T, typename Less>
+void mergeSortBy(std::vector<T>& arr, int l, int r, Less less) {
+    int hi = r + 1;
+    if (hi - l < 2) return;
+
+    std::vector<int> runs;  // run starts, then hi
+    for (int lo = l; lo < hi;) {
+        int end = lo + 1;
+        if (end < hi && less(arr[end], arr[lo])) {
+            while (end < hi && less(arr[end], arr[end - 1])) end++;
+            std::reverse(arr.begin() + lo, arr.begin() + end);
+        } else {
+            while (end < hi && !less(arr[end], arr[end - 1])) end++;
+        }
+        int forced = std::min(hi, lo + MERGE_MIN_RUN);
+        if (end < forced) {
+            insertionSortRange(arr, lo, end, forced, less);
+            end = forced;
+        }
+        runs.push_back(lo);
+        lo = end;
+    }
+    runs.push_back(hi);
+    if (runs.size() <= 2) return;
+
+    std::vector<T> scratch((hi - l) / 2);
+    while (runs.size() > 2) {
+        std::vector<int> merged;
+        size_t i = 0;
+        for (; i + 2 < runs.size(); i += 2) {
+            mergeRuns(arr, runs[i], runs[i + 1], runs[i + 2], scratch, less);
+            merged.push_back(runs[i]);
+        }
+        if (i + 1 < runs.size()) merged.push_back(runs[i]);  // odd run out
+        merged.push_back(hi);
+        runs.swap(merged);
+    }
+}
+
+// -------------------------------------------------------
+// Introsort
+// -------------------------------------------------------
+// Introsort by key(x): quicksort with a ninther pivot (median of three
+// medians-of-three) and a three-way partition, so runs of equal keys
+// are settled in one pass instead of degrading to O(n^2). Only the
+// smaller side is recursed on (stack depth O(log n)). If partitioning
+// still goes badly, past 2*log2(n) levels the range is heapsorted, and
+// ranges under INTRO_CUTOFF are left to insertion sort. Not stable.
+const int INTRO_CUTOFF = 16;
+
+template <typename T, typename KeyFn>
+int median3By(std::vector<T>& arr, int a, int b, int c, KeyFn key) {
+    auto ka = key(arr[a]), kb = key(arr[b]), kc = key(arr[c]);
+    if (ka < kb) return kb < kc ? b : (ka < kc ? c : a);
+    return ka < kc ? a : (kb < kc ? c : b);
+}
+
+// Pivot index for arr[lo, hi): median of three medians-of-three spread
+// over the range, or a plain median of three for short ranges.
+template <typename T, typename KeyFn>
+int nintherBy(std::vector<T>& arr, int lo, int hi, KeyFn key) {
+    int n = hi - lo, mid = lo + n / 2;
+    if (n <= 128) return median3By(arr, lo, mid, hi - 1, key);
+    int s = n / 8;
+    return median3By(arr,
+                     median3By(arr, lo, lo + s, lo + 2 * s, key),
+                     median3By(arr, mid - s, mid, mid + s, key),
+                     median3By(arr, hi - 1 - 2 * s, hi - 1 - s, hi - 1, key), key);
+}
+
+// Dutch-flag partition of arr[lo, hi) around pivot: afterwards
+// [lo, lt) < pivot, [lt, gt) == pivot and [gt, hi) > pivot.
+template <typename T, typename K, typename KeyFn>
+void partition3By(std::vector<T>& arr, int lo, int hi, K pivot, KeyFn key, int& lt, int& gt) {
+    using std::swap;  // records may bring their own swap (see Tracked)
+    int i = lo;
+    lt = lo;
+    gt = hi;
+    while (i < gt) {
+        auto k = key(arr[i]);
+        if (k < pivot) swap(arr[lt++], arr[i++]);
+        else if (pivot < k) swap(arr[i], arr[--gt]);
+        else i++;
+    }
+}
+
+template <typename T, typename KeyFn>
+void siftDownBy(std::vector<T>& arr, int lo, int n, int i, KeyFn key) {
+    T item = std::move(arr[lo + i]);
+    auto k = key(item);
+    while (2 * i + 1 < n) {
+        int child = 2 * i + 1;
+        if (child + 1 < n && key(arr[lo + child]) < key(arr[lo + child + 1])) child++;
+        if (!(k < key(arr[lo + child]))) break;
+        arr[lo + i] = std::move(arr[lo + child]);
+        i = child;
+    }
+    arr[lo + i] = std::move(item);
+}
+
+template <typename T, typename KeyFn>
+void heapSortRangeBy(std::vector<T>& arr, int lo, int hi, KeyFn key) {
+    using std::swap;
+    int n = hi - lo;
+    for (int i = n / 2 - 1; i >= 0; i--) siftDownBy(arr, lo, n, i, key);
+    for (int end = n - 1; end > 0; end--) {
+        swap(arr[lo], arr[lo + end]);
+        siftDownBy(arr, lo, end, 0, key);
+    }
+}
+
+template <typename T, typename KeyFn>
+void introSortBy(std::vector<T>& arr, int lo, int hi, KeyFn key, int depth) {
+    while (hi - lo > INTRO_CUTOFF) {
+        if (depth-- == 0) {
+            heapSortRangeBy(arr, lo, hi, key);
+            return;
+        }
+        int lt, gt;
+        partition3By(arr, lo, hi, key(arr[nintherBy(arr, lo, hi, key)]), key, lt, gt);
+        if (lt - lo < hi - gt) {
+            introSortBy(arr, lo, lt, key, depth);
+            lo = gt;
+        } else {
+            introSortBy(arr, gt, hi, key, depth);
+            hi = lt;
+        }
+    }
+    insertionSortRange(arr, lo, lo, hi, [&](const T& a, const T& b) { return key(a) < key(b); });
+}
+
+// Sorts arr[lo, hi) by key(x).
+template <typename T, typename KeyFn>
+void introSort(std::vector<T>& arr, int lo, int hi, KeyFn key) {
+    int depth = 0;
+    for (int n = hi - lo; n > 1; n >>= 1) depth += 2;
+    introSortBy(arr, lo, hi, key, depth);
+}
+
+// -------------------------------------------------------
+// Parallel sort engine
+// -------------------------------------------------------
+// Thread count for the parallel sorts; 0 means one per hardware thread.
+inline int sortThreads = 0;
+
+inline int sortThreadCount() {
+    if (sortThreads > 0) return sortThreads;
+    int hw = (int)std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// Fork-join pool that lives for one sort call. A worker runs the newest
+// task from its own deque (its cache is still warm for it) and, once that
+// is empty, steals the oldest (largest) task from another worker.
+class StealPool {
+public:
+    typedef std::function<void(int)> Task;  // argument: id of the worker running it
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<long> pending{0};  // spawned but not yet finished
+
+    bool take(int self, Task& out) {
+        {
+            Queue& q = *queues[self];
+            std::lock_guard<std::mutex> g(q.m);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues.size(); k++) {
+            Queue& q = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> g(q.m);
+            if (!q.tasks.empty()) {
+                out = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool runOne(int self) {
+        Task t;
+        if (!take(self, t)) return false;
+        t(self);
+        pending--;
+        return true;
+    }
+
+public:
+    explicit StealPool(int threads) {
+        for (int i = 0; i < std::max(1, threads); i++) queues.emplace_back(new Queue());
+    }
+
+    int size() const { return (int)queues.size(); }
+
+    void spawn(int self, Task t) {
+        pending++;
+        std::lock_guard<std::mutex> g(queues[self]->m);
+        queues[self]->tasks.push_back(std::move(t));
+    }
+
+    // Keeps running tasks until `left` drops to zero, so a task waiting on
+    // its children does useful work instead of blocking a thread.
+    void helpUntil(int self, std::atomic<int>& left) {
+        while (left.load() > 0)
+            if (!runOne(self)) std::this_thread::yield();
+    }
+
+    // Runs root and everything it spawns on all workers; returns when done.
+    void run(Task root) {
+        spawn(0, std::move(root));
+        auto loop = [this](int self) {
+            while (pending.load() > 0)
+                if (!runOne(self)) std::this_thread::yield();
+        };
+        std::vector<std::thread> workers;
+        for (int i = 1; i < size(); i++) workers.emplace_back(loop, i);
+        loop(0);
+        for (auto &w : workers) w.join();
+    }
+};
+
+// Calls f(0) .. f(n - 1) in parallel and waits for all of them.
+template <typename F>
+void forkEach(StealPool& pool, int self, int n, F f) {
+    std::atomic<int> left(n);
+    for (int i = 1; i < n; i++)
+        pool.spawn(self, [&f, &left, i](int) { f(i); left--; });
+    if (n > 0) {
+        f(0);
+        left--;
+    }
+    pool.helpUntil(self, left);
+}
+
+const int PAR_SORT_GRAIN = 1 << 14;     // ranges below this sort serially
+const int PAR_PARTITION_MIN = 1 << 20;  // ranges above this partition in parallel
+
+// Three-way partition of arr[lo, hi) like partition3By, but blocked: every
+// chunk classifies its elements, prefix sums give each chunk its slice of
+// the <, == and > regions in buf, and chunks scatter there and copy back in
+// parallel. Stable within each region.
+template <typename T, typename K, typename KeyFn>
+void parallelPartition3By(StealPool& pool, int self, std::vector<T>& arr, std::vector<T>& buf,
+                          int lo, int hi, K pivot, KeyFn key, int& lt, int& gt) {
+    int chunks = std::max(1, std::min(pool.size() * 4, (hi - lo) / PAR_SORT_GRAIN));
+    auto bound = [&](int c) { return lo + (int)((long long)(hi - lo) * c / chunks); };
+    auto side = [&](const T& x) { auto k = key(x); return k < pivot ? 0 : (pivot < k ? 2 : 1); };
+
+    std::vector<std::array<int, 3>> at(chunks);
+    forkEach(pool, self, chunks, [&](int c) {
+        std::array<int, 3> cnt = {0, 0, 0};
+        for (int i = bound(c); i < bound(c + 1); i++) cnt[side(arr[i])]++;
+        at[c] = cnt;
+    });
+    int start[3] = {lo, 0, 0};
+    int total[3] = {0, 0, 0};
+    for (auto &cnt : at)
+        for (int s = 0; s < 3; s++) total[s] += cnt[s];
+    start[1] = lo + total[0];
+    start[2] = start[1] + total[1];
+    for (auto &cnt : at)
+        for (int s = 0; s < 3; s++) {
+            int n = cnt[s];
+            cnt[s] = start[s];
+            start[s] += n;
+        }
+
+    forkEach(pool, self, chunks, [&](int c) {
+        std::array<int, 3> out = at[c];
+        for (int i = bound(c); i < bound(c + 1); i++) buf[out[side(arr[i])]++] = std::move(arr[i]);
+    });
+    forkEach(pool, self, chunks, [&](int c) {
+        std::move(buf.begin() + bound(c), buf.begin() + bound(c + 1), arr.begin() + bound(c));
+    });
+    lt = lo + total[0];
+    gt = lt + total[1];
+}
+
+template <typename T, typename KeyFn>
+void parallelQuickSortRange(StealPool& pool, int self, std::vector<T>& arr, std::vector<T>& buf,
+                            int lo, int hi, KeyFn key, int depth) {
+    while (hi - lo > PAR_SORT_GRAIN) {
+        if (depth-- == 0) break;  // give up on parallelism; introsort copes
+        int lt, gt;
+        auto pivot = key(arr[nintherBy(arr, lo, hi, key)]);
+        if (hi - lo > PAR_PARTITION_MIN)
+            parallelPartition3By(pool, self, arr, buf, lo, hi, pivot, key, lt, gt);
+        else
+            partition3By(arr, lo, hi, pivot, key, lt, gt);
+
+        // hand the smaller side to the pool, keep the larger
+        int a = lo, b = lt;
+        if (lt - lo < hi - gt) lo = gt;
+        else {
+            a = gt;
+            b = hi;
+            hi = lt;
+        }
+        pool.spawn(self, [&pool, &arr, &buf, a, b, key, depth](int w) {
+            parallelQuickSortRange(pool, w, arr, buf, a, b, key, depth);
+        });
+    }
+    introSort(arr, lo, hi, key);
+}
+
+// Unstable parallel sort of arr by key(x).
+template <typename T, typename KeyFn>
+void parallelQuickSort(std::vector<T>& arr, KeyFn key) {
+    int n = arr.size();
+    StealPool pool(sortThreadCount());
+    if (pool.size() == 1 || n <= PAR_SORT_GRAIN) {
+        introSort(arr, 0, n, key);
+        return;
+    }
+    std::vector<T> buf(n > PAR_PARTITION_MIN ? n : 0);
+    int depth = 0;
+    for (int m = n; m > 1; m >>= 1) depth += 2;
+    pool.run([&](int self) { parallelQuickSortRange(pool, self, arr, buf, 0, n, key, depth); });
+}
+
+// Number of elements of a[0, n1) among the first k of the stable merge of
+// a[0, n1) and b[0, n2) (ties go to a).
+template <typename It, typename Less>
+int mergeSplit(It a, int n1, It b, int n2, int k, Less less) {
+    int lo = std::max(0, k - n2), hi = std::min(k, n1);
+    while (lo < hi) {
+        int i = lo + (hi - lo) / 2, j = k - i;
+        if (j > 0 && i < n1 && !less(b[j - 1], a[i])) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+// Stable parallel sort: chunks are merge-sorted in parallel, then adjacent
+// runs are merged pairwise between arr and one buffer. Every merge is cut
+// into output pieces of PAR_SORT_GRAIN elements whose inputs are found by
+// binary search, so even the last merge uses every thread.
+template <typename T, typename Less>
+void parallelMergeSort(std::vector<T>& arr, Less less) {
+    int n = arr.size();
+    StealPool pool(sortThreadCount());
+    if (pool.size() == 1 || n <= 2 * PAR_SORT_GRAIN) {
+        mergeSortBy(arr, 0, n - 1, less);
+        return;
+    }
+    std::vector<T> buf(n);
+
+    pool.run([&](int self) {
+        int chunks = std::max(2, std::min(pool.size() * 4, n / PAR_SORT_GRAIN));
+        std::vector<int> runs;  // run starts, then n
+        for (int c = 0; c <= chunks; c++) runs.push_back((int)((long long)n * c / chunks));
+        forkEach(pool, self, chunks, [&](int c) { mergeSortBy(arr, runs[c], runs[c + 1] - 1, less); });
+
+        std::vector<T>* src = &arr;
+        std::vector<T>* dst = &buf;
+        while (runs.size() > 2) {
+            struct Piece { int a, b, c, k0, k1; };  // merge [a,b)+[b,c), outputs k0..k1
+            std::vector<Piece> pieces;
+            std::vector<int> merged;
+            for (size_t r = 0; r + 1 < runs.size(); r += 2) {
+                int a = runs[r], b = runs[r + 1];
+                int c = r + 2 < runs.size() ? runs[r + 2] : b;  // odd run out: plain move
+                for (int k = 0; k < c - a; k += PAR_SORT_GRAIN)
+                    pieces.push_back({a, b, c, k, std::min(c - a, k + PAR_SORT_GRAIN)});
+                merged.push_back(a);
+            }
+            merged.push_back(n);
+
+            forkEach(pool, self, (int)pieces.size(), [&](int p) {
+                const Piece& pc = pieces[p];
+                auto A = src->begin() + pc.a, B = src->begin() + pc.b;
+                int n1 = pc.b - pc.a, n2 = pc.c - pc.b;
+                int i = mergeSplit(A, n1, B, n2, pc.k0, less), j = pc.k0 - i;
+                int i1 = mergeSplit(A, n1, B, n2, pc.k1, less), j1 = pc.k1 - i1;
+                auto out = dst->begin() + pc.a + pc.k0;
+                while (i < i1 && j < j1) *out++ = less(B[j], A[i]) ? std::move(B[j++]) : std::move(A[i++]);
+                out = std::move(A + i, A + i1, out);
+                std::move(B + j, B + j1, out);
+            });
+            runs.swap(merged);
+            std::swap(src, dst);
+        }
+
+        if (src != &arr) {
+            int pieces = (n + PAR_SORT_GRAIN - 1) / PAR_SORT_GRAIN;
+            forkEach(pool, self, pieces, [&](int p) {
+                int from = p * PAR_SORT_GRAIN, to = std::min(n, from + PAR_SORT_GRAIN);
+                std::move(buf.begin() + from, buf.begin() + to, arr.begin() + from);
+            });
+        }
+    });
+}
+
+// Stable parallel LSD radix sort by an int key, one byte per pass
+// (at most 2^32 records). The
+// passes shuffle (key, index) pairs rather than records: each thread
+// histograms its chunk, a column-wise prefix sum gives every chunk its
+// own output slots per digit, and chunks scatter independently. Passes
+// where all keys share the digit are skipped. Records move once at the end.
+template <typename T, typename IdFn>
+void parallelRadixSort(std::vector<T>& arr, IdFn id) {
+    size_t n = arr.size();
+    if (n < 2) return;
+    StealPool pool(sortThreadCount());
+    std::vector<uint64_t> cur(n), next(n);
+    std::vector<T> sorted(n);
+
+    pool.run([&](int self) {
+        int chunks = (int)std::max<size_t>(1, std::min<size_t>(pool.size(), n / PAR_SORT_GRAIN));
+        auto bound = [&](int c) { return n * c / chunks; };
+        forkEach(pool, self, chunks, [&](int c) {
+            for (size_t i = bound(c); i < bound(c + 1); i++) {
+                uint32_t k = (uint32_t)id(arr[i]) ^ 0x80000000u;  // signed -> unsigned order
+                cur[i] = (uint64_t)k << 32 | i;
+            }
+        });
+
+        std::vector<std::array<size_t, 256>> hist(chunks);
+        for (int shift = 32; shift < 64; shift += 8) {
+            forkEach(pool, self, chunks, [&](int c) {
+                hist[c].fill(0);
+                for (size_t i = bound(c); i < bound(c + 1); i++) hist[c][(cur[i] >> shift) & 0xff]++;
+            });
+            size_t sum = 0;
+            bool skip = false;
+            for (int d = 0; d < 256; d++)
+                for (int c = 0; c < chunks; c++) {
+                    size_t cnt = hist[c][d];
+                    if (cnt == n) skip = true;
+                    hist[c][d] = sum;
+                    sum += cnt;
+                }
+            if (skip) continue;
+            forkEach(pool, self, chunks, [&](int c) {
+                std::array<size_t, 256> out = hist[c];
+                for (size_t i = bound(c); i < bound(c + 1); i++) next[out[(cur[i] >> shift) & 0xff]++] = cur[i];
+            });
+            cur.swap(next);
+        }
+
+        forkEach(pool, self, chunks, [&](int c) {
+            for (size_t i = bound(c); i < bound(c + 1); i++) sorted[i] = std::move(arr[(uint32_t)cur[i]]);
+        });
+    });
+    arr.swap(sorted);
+}
+
+// -------------------------------------------------------
+// Top-K ranking (bounded heap)
+// -------------------------------------------------------
+// Keeps the k best (key, value) entries offered so far. They sit in a
+// min-heap whose root is the weakest of them, so an entry that does not
+// make the cut costs one comparison and one that does costs O(log k).
+// Higher keys rank first; equal keys rank the smaller value first, which
+// for array indices means earlier records win ties.
+template <typename K, typename V = uint32_t>
+class TopK {
+    typedef std::pair<K, V> Entry;
+    size_t k;
+    std::vector<Entry> heap;  // heap[0] is the weakest entry kept
+
+    // a ranks above b
+    static bool better(const Entry& a, const Entry& b) {
+        return b.first < a.first || (!(a.first < b.first) && a.second < b.second);
+    }
+
+    void siftUp(size_t i) {
+        Entry e = std::move(heap[i]);
+        while (i > 0 && better(heap[(i - 1) / 2], e)) {
+            heap[i] = std::move(heap[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+        heap[i] = std::move(e);
+    }
+
+    void siftDown(size_t i) {
+        Entry e = std::move(heap[i]);
+        size_t n = heap.size();
+        while (2 * i + 1 < n) {
+            size_t c = 2 * i + 1;
+            if (c + 1 < n && better(heap[c], heap[c + 1])) c++;  // weaker child
+            if (!better(e, heap[c])) break;
+            heap[i] = std::move(heap[c]);
+            i = c;
+        }
+        heap[i] = std::move(e);
+    }
+
+public:
+    explicit TopK(size_t k) : k(k) { heap.reserve(k); }
+
+    size_t capacity() const { return k; }
+    size_t size() const { return heap.size(); }
+
+    void offer(const K& key, const V& value) {
+        if (heap.size() < k) {
+            heap.emplace_back(key, value);
+            siftUp(heap.size() - 1);
+        } else if (k > 0 && better(Entry(key, value), heap[0])) {
+            heap[0] = Entry(key, value);
+            siftDown(0);
+        }
+    }
+
+    void merge(const TopK& other) {
+        for (auto &e : other.heap) offer(e.first, e.second);
+    }
+
+    // The kept entries, best first.
+    std::vector<Entry> ranked() const {
+        std::vector<Entry> r = heap;
+        std::sort(r.begin(), r.end(), better);
+        return r;
+    }
+};
+
+// Indices of the k records with the highest key(x), best first: O(n log k)
+// time and O(k) space, the records themselves are never moved.
+template <typename T, typename KeyFn>
+std::vector<uint32_t> topK(const std::vector<T>& arr, size_t k, KeyFn key) {
+    typedef decltype(key(arr[0])) K;
+    TopK<K> best(k);
+    for (size_t i = 0; i < arr.size(); i++) best.offer(key(arr[i]), (uint32_t)i);
+    std::vector<uint32_t> out;
+    for (auto &e : best.ranked()) out.push_back(e.second);
+    return out;
+}
+
+// topK() with each sort thread scanning its own chunk into its own heap;
+// the per-thread heaps (k entries each) are merged at the end.
+template <typename T, typename KeyFn>
+std::vector<uint32_t> parallelTopK(const std::vector<T>& arr, size_t k, KeyFn key) {
+    typedef decltype(key(arr[0])) K;
+    size_t n = arr.size();
+    int threads = sortThreadCount();
+    if (threads == 1 || n < 2 * (size_t)PAR_SORT_GRAIN) return topK(arr, k, key);
+
+    int chunks = (int)std::min<size_t>(threads, n / PAR_SORT_GRAIN);
+    std::vector<TopK<K>> heaps(chunks, TopK<K>(k));
+    StealPool pool(threads);
+    pool.run([&](int self) {
+        forkEach(pool, self, chunks, [&](int c) {
+            for (size_t i = n * c / chunks; i < n * (c + 1) / chunks; i++) heaps[c].offer(key(arr[i]), (uint32_t)i);
+        });
+    });
+    for (int c = 1; c < chunks; c++) heaps[0].merge(heaps[c]);
+    std::vector<uint32_t> out;
+    for (auto &e : heaps[0].ranked()) out.push_back(e.second);
+    return out;
+}
+
+// -------------------------------------------------------
+// Flat hash table (SwissTable-style open addressing)
+// -------------------------------------------------------
+// Records live densely in `entries`; the table itself only holds small
+// (key, entry index) slots. Slots come in groups of 16 with one control
+// byte each: EMPTY, DELETED, or the low 7 bits of the key's hash. A lookup
+// compares a whole group of control bytes at once (SSE2) and only looks at
+// slots whose tag matches. Keys go through a 64-bit mixer, so sequential
+// IDs spread evenly. Past 7/8 load a table of twice the size is allocated
+// and old groups move over a few at a time on later inserts, so no single
+// insert pays for a full rehash.
+template <typename K, typename V>
+class FlatHashTable {
+    static constexpr int8_t EMPTY = -128;
+    static constexpr int8_t DELETED = -2;
+    static constexpr size_t GROUP = 16;
+    static constexpr size_t MIGRATE_GROUPS = 4;  // old groups moved per insert
+
+    struct Slot {
+        K key;
+        uint32_t index;  // position in entries
+    };
+
+    struct Table {
+        std::vector<int8_t> ctrl;
+        std::vector<Slot> slots;
+        size_t groupMask = 0;
+        size_t used = 0;        // live slots
+        size_t tombstones = 0;
+
+        void init(size_t groups) {
+            ctrl.assign(groups * GROUP, EMPTY);
+            slots.resize(groups * GROUP);
+            groupMask = groups - 1;
+            used = tombstones = 0;
+        }
+        size_t capacity() const { return ctrl.size(); }
+    };
+
+    std::vector<std::pair<K, V>> entries;
+    Table cur;
+    Table old;            // previous table while a resize is in progress
+    size_t migrated = 0;  // groups of old already moved into cur
+
+    static uint64_t mix(const K& key) {
+        uint64_t h = (uint64_t)key;
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    // Bit i is set when control byte i of the group equals tag.
+    static unsigned matchGroup(const int8_t* ctrl, int8_t tag) {
+#ifdef __SSE2__
+        __m128i g = _mm_loadu_si128((const __m128i*)ctrl);
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(tag)));
+#else
+        unsigned m = 0;
+        for (size_t i = 0; i < GROUP; i++)
+            if (ctrl[i] == tag) m |= 1u << i;
+        return m;
+#endif
+    }
+
+    // Slot number of key in t, or -1.
+    static long long findIn(const Table& t, const K& key, uint64_t h) {
+        if (t.used == 0) return -1;
+        int8_t tag = (int8_t)(h & 0x7f);
+        size_t g = (h >> 7) & t.groupMask;
+        for (size_t step = 1;; step++) {
+            const int8_t* ctrl = &t.ctrl[g * GROUP];
+            for (unsigned m = matchGroup(ctrl, tag); m != 0; m &= m - 1) {
+                size_t slot = g * GROUP + __builtin_ctz(m);
+                if (t.slots[slot].key == key) return (long long)slot;
+            }
+            if (matchGroup(ctrl, EMPTY) != 0 || step > t.groupMask) return -1;
+            g = (g + step) & t.groupMask;  // triangular probing visits every group
+        }
+    }
+
+    // Claims a slot for a key (with hash h) known to be absent from t.
+    static Slot& placeIn(Table& t, uint64_t h) {
+        size_t g = (h >> 7) & t.groupMask;
+        for (size_t step = 1;; step++) {
+            int8_t* ctrl = &t.ctrl[g * GROUP];
+            unsigned avail = matchGroup(ctrl, EMPTY) | matchGroup(ctrl, DELETED);
+            if (avail != 0) {
+                size_t i = __builtin_ctz(avail);
+                if (ctrl[i] == DELETED) t.tombstones--;
+                ctrl[i] = (int8_t)(h & 0x7f);
+                t.used++;
+                return t.slots[g * GROUP + i];
+            }
+            g = (g + step) & t.groupMask;
+        }
+    }
+
+    Slot* locate(const K& key) {
+        uint64_t h = mix(key);
+        long long s = findIn(cur, key, h);
+        if (s >= 0) return &cur.slots[s];
+        s = findIn(old, key, h);
+        return s >= 0 ? &old.slots[s] : nullptr;
+    }
+
+    void migrateSome(size_t groups) {
+        size_t total = old.capacity() / GROUP;
+        for (size_t n = 0; n < groups && migrated < total; n++, migrated++) {
+            for (size_t i = migrated * GROUP; i < (migrated + 1) * GROUP; i++) {
+                if (old.ctrl[i] < 0) continue;
+                placeIn(cur, mix(old.slots[i].key)) = old.slots[i];
+                old.ctrl[i] = DELETED;  // not EMPTY: later old groups may probe through it
+                old.used--;
+            }
+        }
+        if (migrated == total) {
+            old = Table();
+            migrated = 0;
+        }
+    }
+
+    void startResize(size_t groups) {
+        while (old.capacity() != 0) migrateSome(old.capacity() / GROUP);
+        old = std::move(cur);
+        cur = Table();
+        cur.init(groups);
+        migrated = 0;
+        if (old.used == 0) old = Table();
+    }
+
+public:
+    FlatHashTable(size_t expected = 0) {
+        size_t groups = 1;
+        while (groups * GROUP * 7 / 8 < expected) groups *= 2;
+        cur.init(groups);
+        entries.reserve(expected);
+    }
+
+    size_t size() const { return entries.size(); }
+
+    V* find(const K& key) {
+        Slot* s = locate(key);
+        return s ? &entries[s->index].second : nullptr;
+    }
+
+    // Inserts or overwrites; the reference stays valid until the next insert.
+    V& insert(const K& key, V value) {
+        if (old.capacity() != 0) migrateSome(MIGRATE_GROUPS);
+        if (Slot* s = locate(key)) return entries[s->index].second = std::move(value);
+
+        if ((cur.used + cur.tombstones + 1) * 8 > cur.capacity() * 7) {
+            // grow, or just sweep tombstones out if most of the load is dead
+            size_t groups = cur.capacity() / GROUP;
+            startResize(cur.used * 2 > cur.capacity() * 7 / 8 ? groups * 2 : groups);
+            migrateSome(MIGRATE_GROUPS);
+        }
+        placeIn(cur, mix(key)) = {key, (uint32_t)entries.size()};
+        entries.emplace_back(key, std::move(value));
+        return entries.back().second;
+    }
+
+    bool erase(const K& key) {
+        uint64_t h = mix(key);
+        Table* t = &cur;
+        long long s = findIn(cur, key, h);
+        if (s < 0) {
+            t = &old;
+            s = findIn(old, key, h);
+        }
+        if (s < 0) return false;
+        uint32_t idx = t->slots[s].index;
+        t->ctrl[s] = DELETED;
+        t->used--;
+        t->tombstones++;
+        if (idx + 1 != entries.size()) {  // keep entries dense
+            entries[idx] = std::move(entries.back());
+            locate(entries[idx].first)->index = idx;
+        }
+        entries.pop_back();
+        return true;
+    }
+
+    // Calls f(key, value) for every entry.
+    template <typename F>
+    void forEach(F f) {
+        for (auto &e : entries) f(e.first, e.second);
+    }
+
+    // Forward iteration over the values in place (keys stay read-only).
+    // Like pointers from find(), iterators are invalidated by insert/erase.
+    class iterator {
+        typename std::vector<std::pair<K, V>>::iterator it;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef V value_type;
+        typedef ptrdiff_t difference_type;
+        typedef V* pointer;
+        typedef V& reference;
+
+        explicit iterator(typename std::vector<std::pair<K, V>>::iterator i) : it(i) {}
+        V& operator*() const { return it->second; }
+        V* operator->() const { return &it->second; }
+        const K& key() const { return it->first; }
+        iterator& operator++() { ++it; return *this; }
+        iterator operator++(int) { iterator t = *this; ++it; return t; }
+        bool operator==(const iterator& o) const { return it == o.it; }
+        bool operator!=(const iterator& o) const { return it != o.it; }
+    };
+
+    iterator begin() { return iterator(entries.begin()); }
+    iterator end() { return iterator(entries.end()); }
+};
+
+// Order of arr[0..n) by key(arr[i]): the keys are pulled into a compact
+// (key, index) array and sorted there, so the records themselves never
+// move. Equal keys keep their original order.
+template <typename T, typename KeyFn>
+std::vector<uint32_t> sortIndexByKey(const std::vector<T>& arr, KeyFn key) {
+    typedef decltype(key(arr[0])) Key;
+    std::vector<std::pair<Key, uint32_t>> keyed(arr.size());
+    for (size_t i = 0; i < arr.size(); i++) keyed[i] = {key(arr[i]), (uint32_t)i};
+    std::sort(keyed.begin(), keyed.end());  // index breaks ties, so this is stable
+    std::vector<uint32_t> order(arr.size());
+    for (size_t i = 0; i < keyed.size(); i++) order[i] = keyed[i].second;
+    return order;
+}
+
+// -------------------------------------------------------
+// Benchmark harness (run with --bench)
+// -------------------------------------------------------
+// Every routine is timed on plain records: one warm-up run, then --reps
+// timed runs, each on a fresh copy of the same input, reporting median
+// and p95. A separate untimed run on Tracked records counts key
+// comparisons, swaps and other element moves. Options:
+//   --sizes 10,1000,100000   --reps 5   --threads 0
+//   --dist random,sorted,reversed,few-unique,nearly-sorted
+//   --format csv|json        --count-max 1000000 (largest counted n)
+
+// Operation counts while a routine runs on Tracked records.
+struct BenchCounts {
+    std::atomic<long long> compares{0}, swaps{0}, moves{0};
+    void reset() { compares = 0; swaps = 0; moves = 0; }
+};
+inline BenchCounts benchCounts;
+inline long long benchSink = 0;  // keeps search results observable
+
+// A key whose comparisons are counted.
+template <typename K>
+struct CountedKey {
+    K v;
+    CountedKey() : v() {}
+    CountedKey(K x) : v(x) {}
+    explicit operator K() const { return v; }
+
+    friend bool operator<(const CountedKey& a, const CountedKey& b) {
+        benchCounts.compares.fetch_add(1, std::memory_order_relaxed);
+        return a.v < b.v;
+    }
+    friend bool operator==(const CountedKey& a, const CountedKey& b) {
+        benchCounts.compares.fetch_add(1, std::memory_order_relaxed);
+        return a.v == b.v;
+    }
+    friend bool operator>(const CountedKey& a, const CountedKey& b) { return b < a; }
+    friend bool operator<=(const CountedKey& a, const CountedKey& b) { return !(b < a); }
+    friend bool operator>=(const CountedKey& a, const CountedKey& b) { return !(a < b); }
+    friend bool operator!=(const CountedKey& a, const CountedKey& b) { return !(a == b); }
+};
+
+// A record whose copies, moves and swaps are counted.
+template <typename R>
+struct Tracked {
+    R r;
+    Tracked() {}
+    Tracked(const R& x) : r(x) {}
+    Tracked(const Tracked& o) : r(o.r) { moved(); }
+    Tracked(Tracked&& o) : r(std::move(o.r)) { moved(); }
+    Tracked& operator=(const Tracked& o) { r = o.r; moved(); return *this; }
+    Tracked& operator=(Tracked&& o) { r = std::move(o.r); moved(); return *this; }
+    friend void swap(Tracked& a, Tracked& b) {
+        benchCounts.swaps.fetch_add(1, std::memory_order_relaxed);
+        std::swap(a.r, b.r);
+    }
+    static void moved() { benchCounts.moves.fetch_add(1, std::memory_order_relaxed); }
+};
+
+// One benchmarked routine. make() does the untimed setup (copying the
+// input, building an index) and returns the part to time; counted(), if
+// set, runs the routine once on Tracked records.
+template <typename R>
+struct BenchRoutine {
+    std::string name;
+    long long maxN;  // larger inputs are skipped (quadratic sorts)
+    bool search;     // timed over a batch of ID queries
+    bool linear;     // a search that scans: fewer queries on big inputs
+    std::function<std::function<void()>(const std::vector<R>&, const std::vector<int>&)> make;
+    std::function<void(const std::vector<R>&, const std::vector<int>&)> counted;
+};
+
+// sort(arr) must accept both vector<R> and vector<Tracked<R>>.
+template <typename R, typename F>
+BenchRoutine<R> sortRoutine(const std::string& name, long long maxN, F sort) {
+    BenchRoutine<R> b{name, maxN, false, false, nullptr, nullptr};
+    b.make = [sort](const std::vector<R>& in, const std::vector<int>&) {
+        auto arr = std::make_shared<std::vector<R>>(in);
+        return std::function<void()>([arr, sort] { sort(*arr); });
+    };
+    b.counted = [sort](const std::vector<R>& in, const std::vector<int>&) {
+        std::vector<Tracked<R>> arr(in.begin(), in.end());
+        benchCounts.reset();
+        sort(arr);
+    };
+    return b;
+}
+
+// find(arr, id) returns true on a hit and must accept both record types.
+// With byId the records are sorted by ID during setup.
+template <typename R, typename IdFn, typename F>
+BenchRoutine<R> searchRoutine(const std::string& name, bool linear, bool byId, IdFn id, F find) {
+    BenchRoutine<R> b{name, LLONG_MAX, true, linear, nullptr, nullptr};
+    auto prepare = [byId, id](const std::vector<R>& in) {
+        std::vector<R> arr = in;
+        if (byId) parallelRadixSort(arr, id);
+        return arr;
+    };
+    b.make = [prepare, find](const std::vector<R>& in, const std::vector<int>& q) {
+        auto arr = std::make_shared<std::vector<R>>(prepare(in));
+        return std::function<void()>([arr, &q, find] {
+            long long hits = 0;
+            for (int x : q) hits += find(*arr, x);
+            benchSink += hits;
+        });
+    };
+    b.counted = [prepare, find](const std::vector<R>& in, const std::vector<int>& q) {
+        std::vector<R> sorted = prepare(in);
+        std::vector<Tracked<R>> arr(sorted.begin(), sorted.end());
+        benchCounts.reset();
+        for (int x : q) benchSink += find(arr, x);
+    };
+    return b;
+}
+
+// (id, grade) pairs for n records under a named input distribution; the
+// same order applies to both keys so every sort sees the intended shape.
+inline std::vector<std::pair<int, float>> benchKeys(const std::string& dist, long long n, std::mt19937_64& rng) {
+    std::vector<std::pair<int, float>> k(n);
+    for (long long i = 0; i < n; i++) {
+        if (dist == "random") k[i] = {(int)rng(), (float)(rng() % 1001) / 10};
+        else if (dist == "reversed") k[i] = {(int)(n - i), (float)(100.0 * (n - i) / n)};
+        else if (dist == "few-unique") k[i] = {(int)(rng() % 16), (float)(50 + 10 * (rng() % 5))};
+        else k[i] = {(int)i, (float)(100.0 * i / n)};  // sorted, nearly-sorted
+    }
+    if (dist == "nearly-sorted")
+        for (long long s = 0; s < std::max(1LL, n / 100); s++) std::swap(k[rng() % n], k[rng() % n]);
+    return k;
+}
+
+inline std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t end = s.find(',', start);
+        if (end == std::string::npos) end = s.size();
+        if (end > start) out.push_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    return out;
+}
+
+// Runs every routine on every (distribution, size) pair and prints one
+// row per combination. makeRecord(id, grade) builds a record of type R.
+template <typename R, typename MakeRecord>
+int runBenchmarks(int argc, char** argv, const std::string& file,
+                  const std::vector<BenchRoutine<R>>& routines, MakeRecord makeRecord) {
+    std::vector<long long> sizes = {10, 100, 1000, 10000, 100000, 1000000};
+    std::vector<std::string> dists = {"random", "sorted", "reversed", "few-unique", "nearly-sorted"};
+    int reps = 5;
+    long long countMax = 1000000;
+    std::string format = "csv";
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string opt = argv[i], val = argv[i + 1];
+        if (opt == "--sizes") {
+            sizes.clear();
+            for (auto &x : splitList(val)) sizes.push_back(std::stoll(x));
+        } else if (opt == "--dist") dists = splitList(val);
+        else if (opt == "--reps") reps = std::max(1, std::stoi(val));
+        else if (opt == "--threads") sortThreads = std::stoi(val);
+        else if (opt == "--format") format = val;
+        else if (opt == "--count-max") countMax = std::stoll(val);
+        else {
+            std::cerr << "unknown option " << opt << "\n";
+            return 1;
+        }
+    }
+
+    bool json = format == "json";
+    if (json) std::cout << "[\n";
+    else std::cout << "file,routine,distribution,n,queries,reps,median_ms,p95_ms,compares,swaps,moves,bytes_moved\n";
+    bool first = true;
+    std::mt19937_64 rng(18);
+    for (auto &dist : dists)
+        for (long long n : sizes) {
+            std::vector<std::pair<int, float>> keys = benchKeys(dist, n, rng);
+            std::vector<R> input;
+            input.reserve(n);
+            for (auto &k : keys) input.push_back(makeRecord(k.first, k.second));
+            std::vector<int> pool(100000);  // half present IDs, half random
+            for (auto &q : pool) q = rng() % 2 && n > 0 ? keys[rng() % n].first : (int)rng();
+
+            for (auto &rt : routines) {
+                if (n > rt.maxN) continue;
+                long long nq = !rt.search ? 0 : rt.linear ? std::max(10LL, std::min(100000LL, 20000000LL / std::max(1LL, n))) : 100000;
+                std::vector<int> q(pool.begin(), pool.begin() + nq);
+
+                std::vector<double> ms;
+                for (int r = 0; r <= reps; r++) {  // run 0 is the warm-up
+                    std::function<void()> run = rt.make(input, q);
+                    auto s = std::chrono::steady_clock::now();
+                    run();
+                    double t = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s).count();
+                    if (r > 0) ms.push_back(t);
+                }
+                std::sort(ms.begin(), ms.end());
+                double median = ms[ms.size() / 2];
+                double p95 = ms[std::min(ms.size() - 1, (size_t)(0.95 * ms.size()))];
+
+                long long c = -1, sw = -1, mv = -1, bytes = -1;
+                if (rt.counted && n <= countMax) {
+                    rt.counted(input, q);
+                    c = benchCounts.compares;
+                    sw = benchCounts.swaps;
+                    mv = benchCounts.moves;
+                    bytes = (mv + 2 * sw) * (long long)sizeof(R);
+                }
+
+                if (json) {
+                    std::cout << (first ? "" : ",\n") << "  {\"file\": \"" << file << "\", \"routine\": \"" << rt.name
+                         << "\", \"distribution\": \"" << dist << "\", \"n\": " << n << ", \"queries\": " << q.size()
+                         << ", \"reps\": " << reps << ", \"median_ms\": " << median << ", \"p95_ms\": " << p95
+                         << ", \"compares\": " << c << ", \"swaps\": " << sw << ", \"moves\": " << mv
+                         << ", \"bytes_moved\": " << bytes << "}";
+                } else {
+                    std::cout << file << "," << rt.name << "," << dist << "," << n << "," << q.size() << "," << reps
+                         << "," << median << "," << p95 << "," << c << "," << sw << "," << mv << "," << bytes << "\n";
+                }
+                std::cout.flush();
+                first = false;
+            }
+        }
+    if (json) std::cout << "\n]\n";
+    return 0;
+}
+
+#endif
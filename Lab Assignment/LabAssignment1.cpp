@@ -1,5 +1,23 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <deque>
+#include <unordered_map>
+#include <string_view>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 using namespace std;
 
 struct Item {
@@ -9,57 +27,743 @@ struct Item {
     float price;
 };
 
+// Open-addressing itemID -> slot index (linear probing, power-of-two capacity).
+// Deletion uses backward shifting, so no tombstones are ever left behind.
+class IdIndex {
+    struct Entry {
+        int id;
+        int slot;  // -1 marks an empty entry
+    };
+    vector<Entry> table;
+    size_t mask;
+    size_t used;
+
+    static size_t mix(int id) {
+        uint64_t h = (uint32_t)id;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return (size_t)h;
+    }
+
+    void rehash(size_t capacity) {
+        vector<Entry> old;
+        old.swap(table);
+        table.assign(capacity, Entry{0, -1});
+        mask = capacity - 1;
+        for (auto &e : old) {
+            if (e.slot == -1) continue;
+            size_t i = mix(e.id) & mask;
+            while (table[i].slot != -1) i = (i + 1) & mask;
+            table[i] = e;
+        }
+    }
+
+    size_t locate(int id) const {
+        size_t i = mix(id) & mask;
+        while (table[i].slot != -1 && table[i].id != id) i = (i + 1) & mask;
+        return i;
+    }
+
+public:
+    IdIndex() { used = 0; rehash(16); }
+
+    // Make room for n keys without any further rehashing.
+    void reserve(size_t n) {
+        size_t capacity = table.size();
+        while (n * 10 > capacity * 7) capacity *= 2;
+        if (capacity != table.size()) rehash(capacity);
+    }
+
+    // Pulls the home bucket of id into cache ahead of a find/put.
+    void prefetch(int id) const {
+        __builtin_prefetch(&table[mix(id) & mask]);
+    }
+
+    int find(int id) const {
+        return table[locate(id)].slot;
+    }
+
+    // Insert or overwrite the slot for id.
+    void put(int id, int slot) {
+        reserve(used + 1);
+        size_t i = locate(id);
+        if (table[i].slot == -1) used++;
+        table[i] = {id, slot};
+    }
+
+    void erase(int id) {
+        size_t i = locate(id);
+        if (table[i].slot == -1) return;
+        for (size_t j = (i + 1) & mask; table[j].slot != -1; j = (j + 1) & mask) {
+            size_t home = mix(table[j].id) & mask;
+            // entry j may fill the hole only if its home is not in (i, j]
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i].slot = -1;
+        used--;
+    }
+};
+
 class Inventory {
-    Item items[100];  // fixed-size array
-    int count;
+    vector<Item> items;  // dense storage, deletes move the last item into the hole
+    IdIndex index;       // itemID -> position in items
 
 public:
-    Inventory() { count = 0; }
+    void reserve(size_t n) {
+        items.reserve(n);
+        index.reserve(n);
+    }
+
+    // Builds the item straight from a parsed field, so the name is allocated once.
+    // Existing IDs are overwritten, which is what restocking files expect.
+    bool upsertItem(int id, const char* name, size_t len, int qty, float price) {
+        int pos = index.find(id);
+        if (pos != -1) {
+            items[pos].itemName.assign(name, len);
+            items[pos].quantity = qty;
+            items[pos].price = price;
+            return false;
+        }
+        index.put(id, (int)items.size());
+        items.push_back({id, string(name, len), qty, price});
+        return true;
+    }
+
+    size_t size() const { return items.size(); }
+
+    // Silent primitives: O(1) average, no capacity ceiling.
+    bool addItem(int id, const string& name, int qty, float price) {
+        if (index.find(id) != -1) return false;
+        index.put(id, (int)items.size());
+        items.push_back({id, name, qty, price});
+        return true;
+    }
+
+    bool removeItem(int id) {
+        int pos = index.find(id);
+        if (pos == -1) return false;
+        if (pos != (int)items.size() - 1) {
+            items[pos] = std::move(items.back());
+            index.put(items[pos].itemID, pos);
+        }
+        items.pop_back();
+        index.erase(id);
+        return true;
+    }
+
+    Item* findItem(int id) {
+        int pos = index.find(id);
+        return pos == -1 ? nullptr : &items[pos];
+    }
 
     void insertItem(int id, string name, int qty, float price) {
-        if (count < 100) {
-            items[count++] = {id, name, qty, price};
+        if (addItem(id, name, qty, price))
             cout << "Item inserted successfully.\n";
-        } else {
-            cout << "Inventory full!\n";
-        }
+        else
+            cout << "Item ID already exists!\n";
     }
 
     void deleteItem(int id) {
-        for (int i = 0; i < count; i++) {
-            if (items[i].itemID == id) {
-                for (int j = i; j < count - 1; j++)
-                    items[j] = items[j + 1];
-                count--;
-                cout << "Item deleted.\n";
-                return;
+        if (removeItem(id))
+            cout << "Item deleted.\n";
+        else
+            cout << "Item not found.\n";
+    }
+
+    void searchItem(int id) {
+        Item* it = findItem(id);
+        if (it == nullptr) {
+            cout << "Item not found.\n";
+            return;
+        }
+        cout << "Found: " << it->itemName
+             << " | Qty: " << it->quantity
+             << " | Price: " << it->price << endl;
+    }
+
+    void displayAll() {
+        RowWriter out(cout);
+        out.put("\n--- Inventory List ---\n");
+        for (auto &it : items) {
+            out.putInt(it.itemID);
+            out.put(" | ");
+            out.put(it.itemName.data(), it.itemName.size());
+            out.put(" | Qty: ");
+            out.putInt(it.quantity);
+            out.put(" | Price: ");
+            out.putFloat(it.price);
+            out.put('\n');
+        }
+    }
+
+    // Streams id<delim>name<delim>qty<delim>price lines through one large buffer.
+    bool exportFile(const string& path, char delim) {
+        ofstream file(path, ios::binary);
+        if (!file) return false;
+        RowWriter out(file);
+        for (auto &it : items) {
+            out.putInt(it.itemID);
+            out.put(delim);
+            out.put(it.itemName.data(), it.itemName.size());
+            out.put(delim);
+            out.putInt(it.quantity);
+            out.put(delim);
+            out.putFloat(it.price);
+            out.put('\n');
+        }
+        out.flush();
+        return (bool)file;
+    }
+
+    // Bulk loads a CSV or TSV file (id,name,qty,price per line) in 1 MB blocks.
+    // Fields are parsed in place inside the block; malformed lines (and a
+    // header line, if any) are counted in skipped. Returns -1 if the file
+    // cannot be opened, otherwise the number of lines applied.
+    long long loadFile(const string& path, long long& added, long long& skipped) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (f == NULL) return -1;
+        fseek(f, 0, SEEK_END);
+        long long fileSize = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        bool first = true;
+
+        const size_t BLOCK = 1 << 20;
+        vector<char> buf(BLOCK + 1);
+        size_t carry = 0;
+        bool dropping = false;  // inside a line longer than the block
+        long long applied = 0;
+        added = skipped = 0;
+
+        while (true) {
+            size_t got = fread(buf.data() + carry, 1, BLOCK - carry, f);
+            size_t len = carry + got;
+            bool eof = got == 0;
+            if (len == 0) break;
+            if (eof && buf[len - 1] != '\n') buf[len++] = '\n';  // last line without newline
+            buf[len] = '\0';
+
+            char* p = buf.data();
+            char* end = p + len;
+            if (dropping) {  // discard the rest of the oversized line
+                char* nl = (char*)memchr(p, '\n', end - p);
+                dropping = nl == NULL;
+                p = dropping ? end : nl + 1;
             }
+            if (first) {  // size the store once from the line density of the first block
+                first = false;
+                long long lines = 0;
+                for (char* q = p; (q = (char*)memchr(q, '\n', end - q)) != NULL; q++) lines++;
+                reserve(items.size() + (size_t)(fileSize / (double)len * lines) + 1);
+            }
+            // Parse a batch of rows first and prefetch their index slots, so the
+            // cache misses of the upserts overlap instead of running one by one.
+            bool more = true;
+            while (more) {
+                ParsedRow rows[64];
+                int nrows = 0;
+                while (nrows < 64) {
+                    char* nl = (char*)memchr(p, '\n', end - p);
+                    if (nl == NULL) {
+                        more = false;
+                        break;
+                    }
+                    if (parseLine(p, nl, rows[nrows])) index.prefetch(rows[nrows++].id);
+                    else skipped++;
+                    p = nl + 1;
+                }
+                for (int i = 0; i < nrows; i++) {
+                    ParsedRow& r = rows[i];
+                    added += upsertItem(r.id, r.name, r.nameLen, r.qty, r.price);
+                }
+                applied += nrows;
+            }
+
+            carry = end - p;
+            if (carry == BLOCK) {  // a single line longer than the block
+                skipped++;
+                carry = 0;
+                dropping = true;
+            }
+            memmove(buf.data(), p, carry);
+            if (eof) break;
         }
-        cout << "Item not found.\n";
+        fclose(f);
+        return applied;
     }
 
-    void searchItem(int id) {
-        for (int i = 0; i < count; i++) {
-            if (items[i].itemID == id) {
-                cout << "Found: " << items[i].itemName 
-                     << " | Qty: " << items[i].quantity 
-                     << " | Price: " << items[i].price << endl;
+private:
+    // Buffered writer: formats into a fixed block and hands it to the stream in large writes.
+    class RowWriter {
+        ostream& os;
+        char buf[1 << 16];
+        size_t n;
+
+    public:
+        RowWriter(ostream& o) : os(o) { n = 0; }
+        ~RowWriter() { flush(); }
+
+        void flush() {
+            os.write(buf, n);
+            n = 0;
+        }
+
+        void put(const char* s, size_t len) {
+            if (n + len > sizeof(buf)) flush();
+            if (len > sizeof(buf)) {
+                os.write(s, len);
                 return;
             }
+            memcpy(buf + n, s, len);
+            n += len;
+        }
+
+        void put(const char* s) { put(s, strlen(s)); }
+        void put(char c) { put(&c, 1); }
+
+        void putInt(int v) {
+            char tmp[16];
+            put(tmp, snprintf(tmp, sizeof(tmp), "%d", v));
+        }
+
+        void putFloat(float v) {
+            char tmp[32];
+            put(tmp, snprintf(tmp, sizeof(tmp), "%g", v));  // same digits as cout << v
+        }
+    };
+
+    static bool parseInt(char*& p, int& out) {
+        bool neg = *p == '-';
+        if (neg || *p == '+') p++;
+        if (*p < '0' || *p > '9') return false;
+        long long v = 0, limit = neg ? -(long long)INT_MIN : INT_MAX;
+        while (*p >= '0' && *p <= '9') {
+            v = v * 10 + (*p++ - '0');
+            if (v > limit) return false;  // out of int range
         }
-        cout << "Item not found.\n";
+        out = (int)(neg ? -v : v);
+        return true;
     }
 
-    void displayAll() {
-        cout << "\n--- Inventory List ---\n";
-        for (int i = 0; i < count; i++) {
-            cout << items[i].itemID << " | " << items[i].itemName 
-                 << " | Qty: " << items[i].quantity 
-                 << " | Price: " << items[i].price << endl;
+    struct ParsedRow {
+        int id;
+        const char* name;
+        size_t nameLen;
+        int qty;
+        float price;
+    };
+
+    // Plain decimals ("12", "-3.75") are parsed inline; anything else
+    // (exponents, inf, ...) falls back to strtof.
+    static bool parsePrice(char* p, char* end, float& out) {
+        char* q = p;
+        bool neg = *q == '-';
+        if (neg || *q == '+') q++;
+        long long whole = 0, frac = 0, scale = 1;
+        char* digits = q;
+        while (q < end && *q >= '0' && *q <= '9' && q - digits < 15) whole = whole * 10 + (*q++ - '0');
+        if (q < end && *q == '.') {
+            q++;
+            while (q < end && *q >= '0' && *q <= '9' && scale < 1000000000LL) {
+                frac = frac * 10 + (*q++ - '0');
+                scale *= 10;
+            }
         }
+        if (q == end && q > digits && !(q == digits + 1 && *digits == '.')) {
+            double v = whole + (double)frac / scale;
+            out = (float)(neg ? -v : v);
+            return true;
+        }
+        char* stop;
+        out = strtof(p, &stop);
+        return stop != p && stop == end;
+    }
+
+    // Splits one line [p, nl) in place; the name points into the read block.
+    static bool parseLine(char* p, char* nl, ParsedRow& row) {
+        if (nl > p && nl[-1] == '\r') nl--;
+        if (p == nl) return false;
+
+        if (!parseInt(p, row.id) || (*p != ',' && *p != '\t')) return false;
+        char delim = *p++;
+
+        char* nameEnd = (char*)memchr(p, delim, nl - p);
+        if (nameEnd == NULL) return false;
+        row.name = p;
+        row.nameLen = nameEnd - p;
+        p = nameEnd + 1;
+
+        if (!parseInt(p, row.qty) || *p != delim) return false;
+        p++;
+        return p < nl && parsePrice(p, nl, row.price);
     }
 };
 
+// Interned item names: each distinct name is stored once and referred to by number.
+class NamePool {
+    deque<string> names;  // deque keeps the strings (and their views) in place
+    unordered_map<string_view, int> ids;
+
+public:
+    int intern(string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        names.emplace_back(name);
+        int ref = (int)names.size() - 1;
+        ids.emplace(names.back(), ref);
+        return ref;
+    }
+
+    const string& get(int ref) const { return names[ref]; }
+};
+
+// Vectorised scan kernels over single columns. AVX2 is used when the build
+// enables it (-mavx2), SSE2 otherwise on x86-64, with a scalar tail/fallback.
+
+// Appends every i in [0, n) with qty[i] < limit to out.
+void selectQtyBelow(const int* qty, size_t n, int limit, vector<int>& out) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i vlim = _mm256_set1_epi32(limit);
+    for (; i + 8 <= n; i += 8) {
+        __m256i q = _mm256_loadu_si256((const __m256i*)(qty + i));
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vlim, q)));
+        while (mask) {
+            out.push_back((int)i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i vlim = _mm_set1_epi32(limit);
+    for (; i + 4 <= n; i += 4) {
+        __m128i q = _mm_loadu_si128((const __m128i*)(qty + i));
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vlim, q)));
+        while (mask) {
+            out.push_back((int)i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if (qty[i] < limit) out.push_back((int)i);
+}
+
+// Appends every i in [0, n) with lo <= price[i] <= hi to out.
+void selectPriceBetween(const float* price, size_t n, float lo, float hi, vector<int>& out) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256 vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_loadu_ps(price + i);
+        __m256 in = _mm256_and_ps(_mm256_cmp_ps(p, vlo, _CMP_GE_OQ), _mm256_cmp_ps(p, vhi, _CMP_LE_OQ));
+        unsigned mask = _mm256_movemask_ps(in);
+        while (mask) {
+            out.push_back((int)i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128 vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+    for (; i + 4 <= n; i += 4) {
+        __m128 p = _mm_loadu_ps(price + i);
+        unsigned mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(p, vlo), _mm_cmple_ps(p, vhi)));
+        while (mask) {
+            out.push_back((int)i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if (price[i] >= lo && price[i] <= hi) out.push_back((int)i);
+}
+
+// Sum of qty[i] * price[i], accumulated in double.
+double sumStockValue(const int* qty, const float* price, size_t n) {
+    double total = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m256d q0 = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(qty + i)));
+        __m256d q1 = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(qty + i + 4)));
+        __m256d p0 = _mm256_cvtps_pd(_mm_loadu_ps(price + i));
+        __m256d p1 = _mm256_cvtps_pd(_mm_loadu_ps(price + i + 4));
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(q0, p0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(q1, p1));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128i q = _mm_loadu_si128((const __m128i*)(qty + i));
+        __m128 p = _mm_loadu_ps(price + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_cvtepi32_pd(q), _mm_cvtps_pd(p)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(q, 8)),
+                                           _mm_cvtps_pd(_mm_movehl_ps(p, p))));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) total += (double)qty[i] * price[i];
+    return total;
+}
+
+// Structure-of-arrays Inventory backend: ids, quantities and prices sit in
+// their own contiguous columns, so range queries stream only the column
+// they filter on and never touch the names.
+class ColumnInventory {
+    vector<int> ids;
+    vector<int> qtys;
+    vector<float> prices;
+    vector<int> nameRefs;
+    NamePool names;
+    IdIndex index;  // itemID -> row
+
+public:
+    void reserve(size_t n) {
+        ids.reserve(n);
+        qtys.reserve(n);
+        prices.reserve(n);
+        nameRefs.reserve(n);
+        index.reserve(n);
+    }
+
+    size_t size() const { return ids.size(); }
+
+    bool addItem(int id, string_view name, int qty, float price) {
+        if (index.find(id) != -1) return false;
+        index.put(id, (int)ids.size());
+        ids.push_back(id);
+        qtys.push_back(qty);
+        prices.push_back(price);
+        nameRefs.push_back(names.intern(name));
+        return true;
+    }
+
+    bool removeItem(int id) {
+        int row = index.find(id);
+        if (row == -1) return false;
+        int last = (int)ids.size() - 1;
+        if (row != last) {
+            ids[row] = ids[last];
+            qtys[row] = qtys[last];
+            prices[row] = prices[last];
+            nameRefs[row] = nameRefs[last];
+            index.put(ids[row], row);
+        }
+        ids.pop_back();
+        qtys.pop_back();
+        prices.pop_back();
+        nameRefs.pop_back();
+        index.erase(id);
+        return true;
+    }
+
+    Item getItem(int row) const {
+        return {ids[row], names.get(nameRefs[row]), qtys[row], prices[row]};
+    }
+
+    int findRow(int id) const { return index.find(id); }
+
+    // IDs of all items with quantity < limit.
+    vector<int> itemsWithQtyBelow(int limit) const {
+        vector<int> rows, out;
+        selectQtyBelow(qtys.data(), qtys.size(), limit, rows);
+        out.reserve(rows.size());
+        for (int r : rows) out.push_back(ids[r]);
+        return out;
+    }
+
+    // IDs of all items priced in [lo, hi].
+    vector<int> itemsWithPriceIn(float lo, float hi) const {
+        vector<int> rows, out;
+        selectPriceBetween(prices.data(), prices.size(), lo, hi, rows);
+        out.reserve(rows.size());
+        for (int r : rows) out.push_back(ids[r]);
+        return out;
+    }
+
+    double totalStockValue() const {
+        return sumStockValue(qtys.data(), prices.data(), qtys.size());
+    }
+};
+
+// Row-wise versions of the same queries over Item records, used as the baseline.
+vector<int> rowQtyBelow(const vector<Item>& items, int limit) {
+    vector<int> out;
+    for (auto &it : items)
+        if (it.quantity < limit) out.push_back(it.itemID);
+    return out;
+}
+
+vector<int> rowPriceIn(const vector<Item>& items, float lo, float hi) {
+    vector<int> out;
+    for (auto &it : items)
+        if (it.price >= lo && it.price <= hi) out.push_back(it.itemID);
+    return out;
+}
+
+double rowStockValue(const vector<Item>& items) {
+    double total = 0;
+    for (auto &it : items) total += (double)it.quantity * it.price;
+    return total;
+}
+
+// Times the three queries on the column backend and on a row-wise Item array.
+void benchmarkColumnQueries(int n) {
+    typedef chrono::steady_clock clk;
+    auto ms = [](clk::time_point s, clk::time_point e) {
+        return chrono::duration<double, milli>(e - s).count();
+    };
+
+    mt19937 rng(7);
+    vector<Item> rows;
+    ColumnInventory cols;
+    rows.reserve(n);
+    cols.reserve(n);
+    for (int i = 0; i < n; i++) {
+        string name = "sku" + to_string(i % 5000);  // catalogues repeat names a lot
+        int qty = (int)(rng() % 1000);
+        float price = (float)(rng() % 100000) / 100;
+        rows.push_back({i, name, qty, price});
+        cols.addItem(i, name, qty, price);
+    }
+
+    // keeps the compiler from hoisting a pure query out of the repeat loop
+    auto clobber = [] { asm volatile("" ::: "memory"); };
+    const int reps = 5;
+    size_t hits = 0;
+    double value = 0;
+    double t[6];
+
+    auto s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) hits += rowQtyBelow(rows, 50).size();
+    t[0] = ms(s, clk::now()) / reps;
+    s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) hits += cols.itemsWithQtyBelow(50).size();
+    t[1] = ms(s, clk::now()) / reps;
+
+    s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) value += rowStockValue(rows);
+    t[2] = ms(s, clk::now()) / reps;
+    s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) value -= cols.totalStockValue();
+    t[3] = ms(s, clk::now()) / reps;
+
+    s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) hits += rowPriceIn(rows, 100, 200).size();
+    t[4] = ms(s, clk::now()) / reps;
+    s = clk::now();
+    for (int r = 0; r < reps; r++, clobber()) hits += cols.itemsWithPriceIn(100, 200).size();
+    t[5] = ms(s, clk::now()) / reps;
+
+    cout << "\nQuery over " << n << " items   | row-wise ms | columnar ms\n";
+    cout << "qty < 50              | " << t[0] << " | " << t[1] << "\n";
+    cout << "total stock value     | " << t[2] << " | " << t[3] << "\n";
+    cout << "price in [100, 200]   | " << t[4] << " | " << t[5] << "\n";
+    cout << "(" << hits << " hits, value drift " << value << ")\n";
+}
+
+// Baseline for the benchmark: the original linear-scan array store, minus the 100 cap.
+class ArrayInventory {
+    vector<Item> items;
+
+public:
+    void insertItem(int id, const string& name, int qty, float price) {
+        items.push_back({id, name, qty, price});
+    }
+
+    Item* searchItem(int id) {
+        for (size_t i = 0; i < items.size(); i++)
+            if (items[i].itemID == id) return &items[i];
+        return nullptr;
+    }
+
+    bool deleteItem(int id) {
+        for (size_t i = 0; i < items.size(); i++) {
+            if (items[i].itemID == id) {
+                for (size_t j = i; j + 1 < items.size(); j++)
+                    items[j] = items[j + 1];
+                items.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Compares the hash-indexed Inventory against the array scan from 10^3 up to maxItems.
+// Scan lookups/deletes are sampled (fewer ops at larger n) and reported per operation.
+void benchmarkInventory(int maxItems) {
+    typedef chrono::steady_clock clk;
+    auto nsPerOp = [](clk::time_point s, clk::time_point e, long long ops) {
+        return chrono::duration<double, nano>(e - s).count() / max(ops, 1LL);
+    };
+
+    mt19937 rng(12345);
+    cout << "\n      n | store | insert ns/op | search ns/op | delete ns/op\n";
+
+    for (long long n = 1000; n <= maxItems; n *= 10) {
+        vector<int> ids(n);
+        for (int i = 0; i < n; i++) ids[i] = i + 1;
+        shuffle(ids.begin(), ids.end(), rng);
+
+        long long hashOps = min(n, 1000000LL);
+        long long scanOps = max(10LL, min(n, 100000000LL / n));
+        vector<int> probes(hashOps);
+        for (auto &p : probes) p = ids[rng() % n];
+
+        int found = 0;
+        {
+            Inventory inv;
+            auto s = clk::now();
+            for (int i = 0; i < n; i++) inv.addItem(ids[i], "item", i % 100, 1.5f);
+            auto e = clk::now();
+            double ins = nsPerOp(s, e, n);
+
+            s = clk::now();
+            for (long long i = 0; i < hashOps; i++) found += inv.findItem(probes[i]) != nullptr;
+            e = clk::now();
+            double sea = nsPerOp(s, e, hashOps);
+
+            s = clk::now();
+            for (long long i = 0; i < hashOps; i++) found += inv.removeItem(ids[i]);
+            e = clk::now();
+            double del = nsPerOp(s, e, hashOps);
+
+            cout << n << " | hash  | " << ins << " | " << sea << " | " << del << "\n";
+        }
+        {
+            ArrayInventory inv;
+            auto s = clk::now();
+            for (int i = 0; i < n; i++) inv.insertItem(ids[i], "item", i % 100, 1.5f);
+            auto e = clk::now();
+            double ins = nsPerOp(s, e, n);
+
+            s = clk::now();
+            for (long long i = 0; i < scanOps; i++) found += inv.searchItem(probes[i]) != nullptr;
+            e = clk::now();
+            double sea = nsPerOp(s, e, scanOps);
+
+            s = clk::now();
+            for (long long i = 0; i < scanOps; i++) found += inv.deleteItem(ids[i]);
+            e = clk::now();
+            double del = nsPerOp(s, e, scanOps);
+
+            cout << n << " | array | " << ins << " | " << sea << " | " << del << "\n";
+        }
+        if (found == 0) cout << "(no hits)\n";
+    }
+}
+
 int main() {
     Inventory inv;
     int choice, id, qty;
@@ -67,7 +771,7 @@ int main() {
     float price;
 
     do {
-        cout << "\n1.Insert 2.Delete 3.Search 4.Display 5.Exit\n";
+        cout << "\n1.Insert 2.Delete 3.Search 4.Display 5.Exit 6.Benchmark 7.Load File 8.Export File 9.Query Benchmark\n";
         cout << "Enter choice: ";
         cin >> choice;
 
@@ -93,6 +797,40 @@ int main() {
         case 5:
             cout << "Exiting...\n";
             break;
+        case 6:
+            cout << "Max items (e.g. 10000000): ";
+            cin >> id;
+            benchmarkInventory(id);
+            break;
+        case 7: {
+            long long added, skipped;
+            cout << "Enter CSV/TSV path: ";
+            cin >> name;
+            auto s = chrono::steady_clock::now();
+            long long applied = inv.loadFile(name, added, skipped);
+            auto e = chrono::steady_clock::now();
+            if (applied < 0) {
+                cout << "Cannot open file.\n";
+                break;
+            }
+            cout << applied << " lines loaded (" << added << " new, "
+                 << applied - added << " updated, " << skipped << " skipped) in "
+                 << chrono::duration<double>(e - s).count() << " s\n";
+            break;
+        }
+        case 8:
+            cout << "Enter output path: ";
+            cin >> name;
+            if (inv.exportFile(name, name.size() > 4 && name.substr(name.size() - 4) == ".tsv" ? '\t' : ','))
+                cout << "Exported " << inv.size() << " items.\n";
+            else
+                cout << "Export failed.\n";
+            break;
+        case 9:
+            cout << "Items: ";
+            cin >> id;
+            benchmarkColumnQueries(id);
+            break;
         default:
             cout << "Invalid choice.\n";
         }
@@ -1,43 +1,237 @@
 #include <iostream>
 #include <string>
+#include <vector>
+#include <new>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include <cctype>
+#include <cstdint>
+#include <sstream>
+#include <cerrno>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define UNDO_LOG_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "../Common/BillingPoly.h"
 using namespace std;
 
 // ------------------------------------------------------------
-// 1. Ticket Node (Singly Linked List)
+// 1. Ticket Node (Linked List)
 // ------------------------------------------------------------
 struct Ticket {
     int id;
     string name;
     string issue;
     int priority;
+    int pqHandle;   // handle inside PriorityQueue, -1 when not queued
+    long long serial;  // unique per live ticket, 0 once released to the pool
     Ticket* next;
+    Ticket* prev;
 
     Ticket(int i, string n, string is, int p) {
         id = i;
         name = n;
         issue = is;
         priority = p;
-        next = NULL;
+        pqHandle = -1;
+        serial = 0;
+        next = prev = NULL;
+    }
+};
+
+// ------------------------------------------------------------
+// Slab Pool for Ticket nodes
+// ------------------------------------------------------------
+// Tickets are carved out of 1024-node slabs. Released tickets stay
+// constructed and are chained through their own next pointer, so reusing
+// one just reassigns its fields (and keeps the string buffers).
+class TicketPool {
+    static const int SLAB_SIZE = 1024;
+    vector<Ticket*> slabs;
+    int slabUsed;       // tickets constructed so far in the newest slab
+    Ticket* freeList;
+    long long nextSerial;
+
+public:
+    TicketPool() {
+        slabUsed = SLAB_SIZE;
+        freeList = NULL;
+        nextSerial = 0;
+    }
+
+    TicketPool(const TicketPool&) = delete;
+    TicketPool& operator=(const TicketPool&) = delete;
+
+    ~TicketPool() {
+        for (size_t s = 0; s < slabs.size(); s++) {
+            int built = (s + 1 == slabs.size()) ? slabUsed : SLAB_SIZE;
+            for (int i = 0; i < built; i++)
+                slabs[s][i].~Ticket();
+            ::operator delete(slabs[s]);
+        }
+    }
+
+    Ticket* acquire(int id, const string& name, const string& issue, int p) {
+        if (freeList != NULL) {
+            Ticket* t = freeList;
+            freeList = t->next;
+            t->id = id;
+            t->name = name;
+            t->issue = issue;
+            t->priority = p;
+            t->next = t->prev = NULL;
+            t->serial = ++nextSerial;
+            return t;
+        }
+        if (slabUsed == SLAB_SIZE) {
+            slabs.push_back((Ticket*)::operator new(SLAB_SIZE * sizeof(Ticket)));
+            slabUsed = 0;
+        }
+        Ticket* t = new (&slabs.back()[slabUsed++]) Ticket(id, name, issue, p);
+        t->serial = ++nextSerial;
+        return t;
+    }
+
+    void release(Ticket* t) {
+        t->serial = 0;
+        t->next = freeList;
+        freeList = t;
+    }
+};
+
+// ------------------------------------------------------------
+// Keyword Index over ticket name/issue text
+// ------------------------------------------------------------
+// Splits text into lowercase alphanumeric words.
+vector<string> tokenize(const string& text) {
+    vector<string> words;
+    string w;
+    for (char c : text) {
+        if (isalnum((unsigned char)c)) {
+            w += (char)tolower((unsigned char)c);
+        } else if (!w.empty()) {
+            words.push_back(w);
+            w.clear();
+        }
+    }
+    if (!w.empty()) words.push_back(w);
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+// Inverted index word -> tickets. Postings are appended in serial order,
+// so every list stays sorted by serial and lists intersect by merging.
+// Deletes are lazy: a posting is dead once its ticket's serial changes,
+// and a list is compacted when half of it is dead.
+class KeywordIndex {
+    struct Posting {
+        long long serial;
+        Ticket* t;
+    };
+    struct PostingList {
+        vector<Posting> items;
+        size_t dead = 0;
+    };
+    unordered_map<string, PostingList> lists;
+
+    static bool live(const Posting& p) { return p.t->serial == p.serial; }
+
+public:
+    void add(Ticket* t) {
+        for (auto &w : tokenize(t->name + " " + t->issue))
+            lists[w].items.push_back({t->serial, t});
+    }
+
+    // Call before the ticket is released (while its text is still intact).
+    void remove(Ticket* t) {
+        for (auto &w : tokenize(t->name + " " + t->issue)) {
+            auto it = lists.find(w);
+            if (it == lists.end()) continue;
+            PostingList& pl = it->second;
+            if (++pl.dead * 2 < pl.items.size()) continue;
+            long long gone = t->serial;
+            size_t k = 0;
+            for (auto &p : pl.items)
+                if (live(p) && p.serial != gone) pl.items[k++] = p;
+            pl.items.resize(k);
+            pl.dead = 0;
+            if (k == 0) lists.erase(it);
+        }
+    }
+
+    // Tickets whose text contains every word of the query.
+    vector<Ticket*> query(const string& text) const {
+        vector<Ticket*> result;
+        vector<const vector<Posting>*> terms;
+        for (auto &w : tokenize(text)) {
+            auto it = lists.find(w);
+            if (it == lists.end()) return result;
+            terms.push_back(&it->second.items);
+        }
+        if (terms.empty()) return result;
+        sort(terms.begin(), terms.end(), [](const vector<Posting>* a, const vector<Posting>* b) {
+            return a->size() < b->size();
+        });
+
+        vector<Posting> cur;
+        for (auto &p : *terms[0])
+            if (live(p)) cur.push_back(p);
+        for (size_t k = 1; k < terms.size() && !cur.empty(); k++) {
+            const vector<Posting>& other = *terms[k];
+            size_t i = 0, j = 0, n = 0;
+            while (i < cur.size() && j < other.size()) {
+                if (cur[i].serial < other[j].serial) i++;
+                else if (cur[i].serial > other[j].serial) j++;
+                else {
+                    cur[n++] = cur[i++];
+                    j++;
+                }
+            }
+            cur.resize(n);
+        }
+        for (auto &p : cur) result.push_back(p.t);
+        return result;
     }
 };
 
-// Singly Linked List for Tickets
+// Doubly Linked List for Tickets, with an ID hash index and keyword index
 class TicketList {
+    TicketPool pool;  // owns every node; freed with the list
+    unordered_map<int, Ticket*> byId;
+    KeywordIndex words;
+
 public:
     Ticket* head;
+    Ticket* tail;
 
-    TicketList() { head = NULL; }
+    TicketList() { head = tail = NULL; }
 
-    void insertTicket(int id, string name, string issue, int priority) {
-        Ticket* t = new Ticket(id, name, issue, priority);
-        if (head == NULL) {
-            head = t;
-        } else {
-            Ticket* temp = head;
-            while (temp->next != NULL) temp = temp->next;
-            temp->next = t;
+    // Returns the new ticket, or NULL if the ID is already taken.
+    Ticket* insertTicket(int id, string name, string issue, int priority, bool announce = true) {
+        if (byId.count(id)) {
+            cout << "Ticket ID already exists.\n";
+            return NULL;
         }
-        cout << "Ticket Added.\n";
+        Ticket* t = pool.acquire(id, name, issue, priority);
+        t->prev = tail;
+        if (head == NULL) head = t;
+        else tail->next = t;
+        tail = t;
+        byId[id] = t;
+        words.add(t);
+        if (announce) cout << "Ticket Added.\n";
+        return t;
     }
 
     void deleteTicket(int id) {
@@ -45,35 +239,31 @@ public:
             cout << "List Empty.\n";
             return;
         }
-        if (head->id == id) {
-            Ticket* del = head;
-            head = head->next;
-            delete del;
-            cout << "Ticket Deleted.\n";
-            return;
-        }
-        Ticket* temp = head;
-        while (temp->next != NULL && temp->next->id != id)
-            temp = temp->next;
-
-        if (temp->next == NULL) {
+        auto it = byId.find(id);
+        if (it == byId.end()) {
             cout << "Ticket not found.\n";
             return;
         }
+        Ticket* del = it->second;
+        byId.erase(it);
+        words.remove(del);
+
+        if (del->prev != NULL) del->prev->next = del->next;
+        else head = del->next;
+        if (del->next != NULL) del->next->prev = del->prev;
+        else tail = del->prev;
 
-        Ticket* del = temp->next;
-        temp->next = del->next;
-        delete del;
+        pool.release(del);
         cout << "Ticket Deleted.\n";
     }
 
     Ticket* search(int id) {
-        Ticket* t = head;
-        while (t != NULL) {
-            if (t->id == id) return t;
-            t = t->next;
-        }
-        return NULL;
+        auto it = byId.find(id);
+        return it == byId.end() ? NULL : it->second;
+    }
+
+    vector<Ticket*> searchKeywords(const string& text) const {
+        return words.query(text);
     }
 
     void display() {
@@ -87,145 +277,764 @@ public:
 };
 
 // ------------------------------------------------------------
-// 2. Stack for Undo Operations
+// 2. Undo Log
 // ------------------------------------------------------------
-class UndoStack {
+// Undo history is a ring of fixed-size operation records. It grows on
+// demand up to a memory budget; past that, the oldest records are dropped.
+// When given a file, the ring lives in a shared mapping of that file
+// (header + records), so each push/pop touches one record and the header
+// and the history is paged out by the OS instead of held in memory.
+// An add record carries the whole ticket, and every ticket in the list
+// came from an add that has not been undone, so on startup main replays
+// the file to bring the tickets back before taking new input. Only the
+// tickets whose records were dropped past the budget are not restored.
+enum UndoOp { UNDO_ADD_TICKET = 1 };
+const int UNDO_TEXT = 58;  // bytes for name/issue, terminator included
+
+struct UndoRecord {
+    int32_t op;
+    int32_t id;
+    int32_t priority;
+    char name[UNDO_TEXT];
+    char issue[UNDO_TEXT];
+};
+
+// Name/issue longer than a record holds are cut to UNDO_TEXT - 1 bytes.
+UndoRecord addTicketRecord(int id, const string& name, const string& issue, int priority) {
+    UndoRecord r = {UNDO_ADD_TICKET, id, priority, {}, {}};
+    name.copy(r.name, UNDO_TEXT - 1);
+    issue.copy(r.issue, UNDO_TEXT - 1);
+    return r;
+}
+
+string recordText(const char (&text)[UNDO_TEXT]) {
+    return string(text, find(text, text + UNDO_TEXT, '\0'));
+}
+
+class UndoLog {
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity;   // records in the ring
+        uint64_t first;      // logical index of the oldest record
+        uint64_t end;        // logical index one past the newest record
+    };
+    static const uint64_t MAGIC = 0x33474f4c4f444e55ULL;  // "UNDOLOG3"
+
+    Header local;
+    Header* hdr;
+    UndoRecord* slots;
+    vector<UndoRecord> memSlots;
+    size_t limit;
+    void* mapping;
+    size_t mapBytes;
+
+    void grow() {
+        size_t cap = min(limit, max<size_t>(16, hdr->capacity * 2));
+        vector<UndoRecord> bigger(cap);
+        for (uint64_t i = hdr->first; i < hdr->end; i++)
+            bigger[i - hdr->first] = slots[i % hdr->capacity];
+        memSlots.swap(bigger);
+        slots = memSlots.data();
+        hdr->end -= hdr->first;
+        hdr->first = 0;
+        hdr->capacity = cap;
+    }
+
+    // A new path gets a fresh log. An existing file is only reused if it
+    // is an undo log; anything else is left untouched.
+    bool mapFile(const string& path) {
+#ifdef UNDO_LOG_MMAP
+        size_t bytes = sizeof(Header) + limit * sizeof(UndoRecord);
+        bool fresh = true;
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0 && errno == EEXIST) {
+            fresh = false;
+            fd = open(path.c_str(), O_RDWR);
+            Header h;
+            if (fd >= 0 && (pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || h.magic != MAGIC)) {
+                cout << path << " is not an undo log; not overwriting it.\n";
+                close(fd);
+                return false;
+            }
+        }
+        if (fd < 0) return false;
+        // the file is sparse, so unused records take no disk space; a log
+        // written with another budget is resized and starts empty
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size != bytes) {
+            fresh = true;
+            if (ftruncate(fd, bytes) != 0) {
+                close(fd);
+                return false;
+            }
+        }
+        void* m = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED) return false;
+
+        mapping = m;
+        mapBytes = bytes;
+        hdr = (Header*)m;
+        slots = (UndoRecord*)((char*)m + sizeof(Header));
+        if (fresh || hdr->capacity != limit || hdr->end - hdr->first > limit) {
+            *hdr = {MAGIC, limit, 0, 0};
+        }
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
 public:
-    int top;
-    int arr[100];
+    // budgetBytes caps the records kept; path (optional) makes the log durable.
+    UndoLog(size_t budgetBytes = 1 << 20, const string& path = "") {
+        limit = max<size_t>(1, budgetBytes / sizeof(UndoRecord));
+        local = {MAGIC, 0, 0, 0};
+        hdr = &local;
+        slots = NULL;
+        mapping = NULL;
+        mapBytes = 0;
+        if (!path.empty() && !mapFile(path))
+            cout << "Undo log file unavailable, keeping history in memory only.\n";
+    }
+
+    UndoLog(const UndoLog&) = delete;
+    UndoLog& operator=(const UndoLog&) = delete;
+
+    ~UndoLog() {
+#ifdef UNDO_LOG_MMAP
+        if (mapping != NULL) munmap(mapping, mapBytes);
+#endif
+    }
+
+    size_t size() const { return hdr->end - hdr->first; }
 
-    UndoStack() { top = -1; }
+    // i-th record still held, oldest first.
+    const UndoRecord& operator[](size_t i) const {
+        return slots[(hdr->first + i) % hdr->capacity];
+    }
+    bool durable() const { return mapping != NULL; }
 
-    void push(int id) {
-        arr[++top] = id;
+    void push(UndoRecord r) {
+        if (size() == hdr->capacity) {
+            if (hdr->capacity < limit) grow();
+            else hdr->first++;  // over budget: forget the oldest operation
+        }
+        slots[hdr->end % hdr->capacity] = r;
+        hdr->end++;  // publish after the record is written
     }
 
-    int pop() {
-        if (top == -1) return -1;
-        return arr[top--];
+    bool pop(UndoRecord& r) {
+        if (size() == 0) return false;
+        r = slots[(hdr->end - 1) % hdr->capacity];
+        hdr->end--;
+        return true;
     }
 };
 
 // ------------------------------------------------------------
 // 3. Priority Queue (For urgent tickets)
 // ------------------------------------------------------------
+// 4-ary min-heap keyed by (priority, arrival sequence): equal priorities
+// leave in FIFO order. enqueue hands back a handle (also kept in
+// Ticket::pqHandle) that updatePriority/remove use to find the entry
+// without searching. Entries remember the ticket's serial; once the
+// ticket is deleted the entry is stale and is dropped when it surfaces.
 class PriorityQueue {
+    struct Entry {
+        int priority;
+        int handle;
+        long long seq;
+        long long serial;
+        Ticket* t;
+    };
+    vector<Entry> heap;
+    vector<int> pos;          // handle -> index in heap, -1 when unused
+    vector<int> freeHandles;
+    long long nextSeq;
+
+    static bool before(const Entry& a, const Entry& b) {
+        return a.priority != b.priority ? a.priority < b.priority : a.seq < b.seq;
+    }
+
+    void place(int i, const Entry& e) {
+        heap[i] = e;
+        pos[e.handle] = i;
+    }
+
+    void siftUp(int i) {
+        Entry e = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 4;
+            if (!before(e, heap[parent])) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, e);
+    }
+
+    void siftDown(int i) {
+        Entry e = heap[i];
+        int n = heap.size();
+        while (true) {
+            int first = 4 * i + 1;
+            if (first >= n) break;
+            int best = first;
+            int last = min(first + 4, n);
+            for (int c = first + 1; c < last; c++)
+                if (before(heap[c], heap[best])) best = c;
+            if (!before(heap[best], e)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+    static bool live(const Entry& e) { return e.t->serial == e.serial; }
+
+    // Takes the entry at heap index i out and returns it.
+    Entry removeAt(int i) {
+        Entry e = heap[i];
+        pos[e.handle] = -1;
+        freeHandles.push_back(e.handle);
+        if (live(e)) e.t->pqHandle = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (i < (int)heap.size()) {
+            place(i, last);
+            if (i > 0 && before(last, heap[(i - 1) / 4])) siftUp(i);
+            else siftDown(i);
+        }
+        return e;
+    }
+
 public:
-    Ticket* arr[100];
-    int size;
+    PriorityQueue() { nextSeq = 0; }
 
-    PriorityQueue() { size = 0; }
+    int size() const { return heap.size(); }
 
-    void enqueue(Ticket* t) {
-        arr[size++] = t;
+    int enqueue(Ticket* t) {
+        int h;
+        if (!freeHandles.empty()) {
+            h = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            h = pos.size();
+            pos.push_back(-1);
+        }
+        heap.push_back({t->priority, h, nextSeq++, t->serial, t});
+        pos[h] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+        t->pqHandle = h;
+        return h;
     }
 
     Ticket* dequeue() {
-        if (size == 0) return NULL;
+        while (!heap.empty()) {
+            Entry e = removeAt(0);
+            if (live(e)) return e.t;
+        }
+        return NULL;
+    }
 
-        int best = 0;
-        for (int i = 1; i < size; i++) {
-            if (arr[i]->priority < arr[best]->priority)
-                best = i;
+    // Re-prioritises a queued ticket in place; it keeps its arrival order
+    // among tickets of the new priority.
+    bool updatePriority(int handle, int priority) {
+        if (handle < 0 || handle >= (int)pos.size() || pos[handle] == -1) return false;
+        int i = pos[handle];
+        if (!live(heap[i])) {
+            removeAt(i);
+            return false;
         }
+        int old = heap[i].priority;
+        heap[i].priority = priority;
+        heap[i].t->priority = priority;
+        if (priority < old) siftUp(i);
+        else siftDown(i);
+        return true;
+    }
 
-        Ticket* temp = arr[best];
-        arr[best] = arr[size-1];
-        size--;
-        return temp;
+    Ticket* remove(int handle) {
+        if (handle < 0 || handle >= (int)pos.size() || pos[handle] == -1) return NULL;
+        Entry e = removeAt(pos[handle]);
+        return live(e) ? e.t : NULL;
     }
 };
 
+// Throughput of the heap against the old linear-scan dequeue, at a steady
+// queue depth: prefill to depth, then alternate enqueue/dequeue.
+void benchmarkPriorityQueue() {
+    typedef chrono::steady_clock clk;
+    mt19937 rng(42);
+
+    cout << "\n  depth | heap Mops/s | scan Mops/s\n";
+    for (int depth = 100; depth <= 100000; depth *= 10) {
+        long long heapOps = 400000;
+        long long scanOps = min(400000LL, 2000000000LL / depth);
+
+        vector<Ticket> tickets;
+        tickets.reserve(depth + heapOps);
+        for (long long i = 0; i < depth + heapOps; i++)
+            tickets.emplace_back((int)i, "", "", (int)(rng() % 5) + 1);
+
+        PriorityQueue pq;
+        for (int i = 0; i < depth; i++) pq.enqueue(&tickets[i]);
+        long long sum = 0;
+        auto s = clk::now();
+        for (long long i = 0; i < heapOps; i += 2) {
+            pq.enqueue(&tickets[depth + i]);
+            sum += pq.dequeue()->id;
+        }
+        double heapRate = heapOps / chrono::duration<double, micro>(clk::now() - s).count();
+
+        vector<Ticket*> arr;  // the old scan-based queue
+        for (int i = 0; i < depth; i++) arr.push_back(&tickets[i]);
+        s = clk::now();
+        for (long long i = 0; i < scanOps; i += 2) {
+            arr.push_back(&tickets[depth + i]);
+            int best = 0;
+            for (int j = 1; j < (int)arr.size(); j++)
+                if (arr[j]->priority < arr[best]->priority) best = j;
+            sum += arr[best]->id;
+            arr[best] = arr.back();
+            arr.pop_back();
+        }
+        double scanRate = scanOps / chrono::duration<double, micro>(clk::now() - s).count();
+
+        cout << depth << " | " << heapRate << " | " << scanRate << (sum == 0 ? " *" : "") << "\n";
+    }
+}
+
 // ------------------------------------------------------------
 // 4. Circular Queue (Round-Robin Tickets)
 // ------------------------------------------------------------
+// Bounded lock-free multi-producer/multi-consumer ring (Vyukov style).
+// Every slot carries a sequence number telling producers and consumers
+// whose turn it is, so the only contended writes are the CAS on the
+// enqueue/dequeue cursors. Capacity is rounded up to a power of two.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+// Spin a little, then start yielding the core.
+struct Backoff {
+    int spins = 1;
+
+    void pause() {
+        if (spins <= 64) {
+            for (int i = 0; i < spins; i++) cpuRelax();
+            spins *= 2;
+        } else {
+            this_thread::yield();
+        }
+    }
+};
+
+template <typename T>
 class CircularQueue {
+    struct alignas(64) Slot {
+        atomic<size_t> seq;
+        T data;
+    };
+    vector<Slot> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) atomic<size_t> dequeuePos;
+
 public:
-    int front, rear, count;
-    Ticket* arr[20];
+    CircularQueue(size_t capacity = 1024) : slots(1) {
+        size_t cap = 2;
+        while (cap < capacity) cap *= 2;
+        vector<Slot> s(cap);
+        slots.swap(s);
+        mask = cap - 1;
+        for (size_t i = 0; i < cap; i++)
+            slots[i].seq.store(i, memory_order_relaxed);
+        enqueuePos.store(0, memory_order_relaxed);
+        dequeuePos.store(0, memory_order_relaxed);
+    }
 
-    CircularQueue() {
-        front = rear = count = 0;
+    CircularQueue(const CircularQueue&) = delete;
+    CircularQueue& operator=(const CircularQueue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    bool tryEnqueue(const T& value) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t seq = slot->seq.load(memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false;  // full
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+        slot->data = value;
+        slot->seq.store(pos + 1, memory_order_release);
+        return true;
     }
 
-    void enqueue(Ticket* t) {
-        if (count == 20) {
-            cout << "Circular Queue Full.\n";
-            return;
+    bool tryDequeue(T& out) {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos & mask];
+            size_t seq = slot->seq.load(memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (dif == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeuePos.load(memory_order_relaxed);
+            }
         }
-        arr[rear] = t;
-        rear = (rear + 1) % 20;
-        count++;
+        out = slot->data;
+        slot->seq.store(pos + mask + 1, memory_order_release);
+        return true;
     }
 
-    Ticket* dequeue() {
-        if (count == 0) return NULL;
-        Ticket* t = arr[front];
-        front = (front + 1) % 20;
-        count--;
-        return t;
+    // Blocking variants: back off until there is room / an item.
+    void enqueueWait(const T& value) {
+        Backoff b;
+        while (!tryEnqueue(value)) b.pause();
+    }
+
+    T dequeueWait() {
+        T out;
+        Backoff b;
+        while (!tryDequeue(out)) b.pause();
+        return out;
     }
+
+    // Single-threaded convenience calls used by the menu.
+    void enqueue(const T& value) {
+        if (!tryEnqueue(value)) cout << "Circular Queue Full.\n";
+    }
+
+    T dequeue() {
+        T out = T();
+        tryDequeue(out);
+        return out;
+    }
+};
+
+// Round-robin slots hold the ticket together with its serial, so a
+// deleted (or recycled) ticket is recognised and skipped on dequeue.
+struct TicketRef {
+    Ticket* t = NULL;
+    long long serial = 0;
+
+    bool live() const { return t != NULL && t->serial == serial; }
 };
 
+// N producers push timestamps through one ring while M consumers pop
+// them; reports throughput and enqueue-to-dequeue latency percentiles.
+void stressCircularQueue(int producers, int consumers, long long items) {
+    typedef chrono::steady_clock clk;
+    CircularQueue<long long> q(4096);
+    atomic<long long> consumed(0);
+    vector<vector<long long>> latency(consumers);
+    long long perProducer = items / producers;
+    items = perProducer * producers;
+
+    auto nowNs = [] {
+        return (long long)chrono::duration_cast<chrono::nanoseconds>(
+                   clk::now().time_since_epoch()).count();
+    };
+
+    vector<thread> threads;
+    auto start = clk::now();
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&] {
+            for (long long i = 0; i < perProducer; i++) q.enqueueWait(nowNs());
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&, c] {
+            vector<long long>& lat = latency[c];
+            lat.reserve(items / consumers + 1);
+            Backoff b;
+            while (consumed.load(memory_order_relaxed) < items) {
+                long long stamp;
+                if (q.tryDequeue(stamp)) {
+                    lat.push_back(nowNs() - stamp);
+                    consumed.fetch_add(1, memory_order_relaxed);
+                    b = Backoff();
+                } else {
+                    b.pause();
+                }
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    double secs = chrono::duration<double>(clk::now() - start).count();
+
+    vector<long long> all;
+    for (auto &l : latency) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    auto pct = [&](double p) { return all.empty() ? 0 : all[(size_t)(p * (all.size() - 1))]; };
+
+    cout << producers << "P/" << consumers << "C: " << items / secs / 1e6 << " Mops/s, latency ns p50 "
+         << pct(0.50) << " p99 " << pct(0.99) << " p99.9 " << pct(0.999) << "\n";
+}
+
 // ------------------------------------------------------------
 // 5. Polynomial Linked List for Billing History
 // ------------------------------------------------------------
+// Evaluation and products run on the shared engine in BillingPoly.h.
 struct Poly {
-    int coeff;
+    long long coeff;
     int exp;
     Poly* next;
 
-    Poly(int c, int e) {
+    Poly(long long c, int e) {
         coeff = c;
         exp = e;
         next = NULL;
     }
 };
 
+// Billing polynomial kept in canonical form: exponents strictly descending,
+// equal exponents merged, zero terms dropped. Two bills are therefore equal
+// exactly when their lists match term by term, and add/subtract are a
+// single merge pass. Coefficient arithmetic is checked: an operation whose
+// result has a coefficient outside 64 bits returns false instead of a
+// wrapped value, the same way BillingPoly::evaluate reports overflow.
 class PolyList {
+    void appendTerm(long long c, int e) {  // e must be below tail->exp
+        Poly* p = new Poly(c, e);
+        if (head == NULL) head = p;
+        else tail->next = p;
+        tail = p;
+    }
+
 public:
     Poly* head;
+    Poly* tail;
 
-    PolyList() { head = NULL; }
+    PolyList() { head = tail = NULL; }
 
-    void insertTerm(int c, int e) {
-        Poly* p = new Poly(c, e);
-        if (head == NULL) head = p;
-        else {
-            Poly* t = head;
-            while (t->next != NULL) t = t->next;
-            t->next = p;
+    PolyList(const PolyList& other) {
+        head = tail = NULL;
+        for (Poly* t = other.head; t != NULL; t = t->next) appendTerm(t->coeff, t->exp);
+    }
+
+    PolyList(PolyList&& other) {
+        head = other.head;
+        tail = other.tail;
+        other.head = other.tail = NULL;
+    }
+
+    PolyList& operator=(PolyList other) {
+        swap(head, other.head);
+        swap(tail, other.tail);
+        return *this;
+    }
+
+    ~PolyList() { clear(); }
+
+    void clear() {
+        while (head != NULL) {
+            Poly* next = head->next;
+            delete head;
+            head = next;
         }
+        tail = NULL;
     }
 
-    int evaluate(int x) {
-        int sum = 0;
+    // Adds c*x^e at its sorted position. Negative exponents are not valid
+    // in a bill and are ignored. Returns false, leaving the bill unchanged,
+    // if merging with an existing x^e term overflows.
+    bool insertTerm(long long c, int e) {
+        if (e < 0 || c == 0) return true;
+        Poly* prev = NULL;
         Poly* t = head;
-        while (t != NULL) {
-            int value = 1;
-            for (int i = 0; i < t->exp; i++)
-                value *= x;
-            sum += t->coeff * value;
+        while (t != NULL && t->exp > e) {
+            prev = t;
             t = t->next;
         }
-        return sum;
+        if (t != NULL && t->exp == e) {
+            if (__builtin_add_overflow(t->coeff, c, &t->coeff)) return false;
+            if (t->coeff == 0) {
+                if (prev == NULL) head = t->next;
+                else prev->next = t->next;
+                if (tail == t) tail = prev;
+                delete t;
+            }
+            return true;
+        }
+        Poly* p = new Poly(c, e);
+        p->next = t;
+        if (prev == NULL) head = p;
+        else prev->next = p;
+        if (t == NULL) tail = p;
+        return true;
     }
+
+    // Builds a canonical list from terms in any order with one sort.
+    // Returns false if a merged coefficient does not fit in 64 bits.
+    static bool fromTerms(vector<pair<long long, int>> terms, PolyList& out) {
+        sort(terms.begin(), terms.end(), [](const pair<long long, int>& a, const pair<long long, int>& b) {
+            return a.second > b.second;
+        });
+        PolyList r;
+        for (size_t i = 0; i < terms.size();) {
+            int e = terms[i].second;
+            __int128 c = 0;
+            for (; i < terms.size() && terms[i].second == e; i++) c += terms[i].first;
+            if (c > INT64_MAX || c < INT64_MIN) return false;
+            if (e >= 0 && c != 0) r.appendTerm((long long)c, e);
+        }
+        out = std::move(r);
+        return true;
+    }
+
+    vector<pair<long long, int>> terms() const {
+        vector<pair<long long, int>> out;
+        for (Poly* t = head; t != NULL; t = t->next) out.push_back({t->coeff, t->exp});
+        return out;
+    }
+
+    BillingPoly compile() const {
+        return BillingPoly::fromTerms(terms());
+    }
+
+    // Returns false on 64-bit overflow.
+    bool evaluate(long long x, long long& out) const {
+        return compile().evaluate(x, out);
+    }
+
+    string toString() const {
+        if (head == NULL) return "0";
+        ostringstream os;
+        for (Poly* t = head; t != NULL; t = t->next) {
+            long long c = t->coeff;
+            if (t != head) os << (c < 0 ? " - " : " + ");
+            else if (c < 0) os << "-";
+            unsigned long long mag = c < 0 ? 0ULL - (unsigned long long)c : c;
+            if (mag != 1 || t->exp == 0) os << mag;
+            if (t->exp > 0) os << "x";
+            if (t->exp > 1) os << "^" << t->exp;
+        }
+        return os.str();
+    }
+
+    // out = a + sign * b in one merge over both sorted lists. Returns false,
+    // leaving out untouched, if a coefficient does not fit in 64 bits.
+    static bool combine(const PolyList& a, const PolyList& b, int sign, PolyList& out) {
+        PolyList r;
+        Poly* p = a.head;
+        Poly* q = b.head;
+        long long c;
+        while (p != NULL || q != NULL) {
+            if (q == NULL || (p != NULL && p->exp > q->exp)) {
+                r.appendTerm(p->coeff, p->exp);
+                p = p->next;
+            } else if (p == NULL || q->exp > p->exp) {
+                if (sign > 0) c = q->coeff;
+                else if (__builtin_sub_overflow(0LL, q->coeff, &c)) return false;
+                r.appendTerm(c, q->exp);
+                q = q->next;
+            } else {
+                bool over = sign > 0 ? __builtin_add_overflow(p->coeff, q->coeff, &c)
+                                     : __builtin_sub_overflow(p->coeff, q->coeff, &c);
+                if (over) return false;
+                if (c != 0) r.appendTerm(c, p->exp);
+                p = p->next;
+                q = q->next;
+            }
+        }
+        out = std::move(r);
+        return true;
+    }
+
+    bool operator==(const PolyList& other) const {
+        Poly* p = head;
+        Poly* q = other.head;
+        while (p != NULL && q != NULL) {
+            if (p->exp != q->exp || p->coeff != q->coeff) return false;
+            p = p->next;
+            q = q->next;
+        }
+        return p == NULL && q == NULL;
+    }
+
+    bool operator!=(const PolyList& other) const { return !(*this == other); }
 };
 
+// out = a * b (see multiplyTerms). Returns false, leaving out untouched,
+// if a coefficient of the product does not fit in 64 bits.
+bool multiplyBills(const PolyList& a, const PolyList& b, PolyList& out) {
+    BillTerms product;
+    if (!multiplyTerms(a.terms(), b.terms(), product)) return false;
+    return PolyList::fromTerms(product, out);
+}
+
+// Month-end style run: one bill evaluated at customers x = 1..n, batch
+// kernel against one checked evaluation per customer.
+void benchmarkBatchBilling(const PolyList& bill, int n) {
+    typedef chrono::steady_clock clk;
+    BillingPoly p = bill.compile();
+    vector<long long> xs(n), batch, single(n);
+    vector<char> overflow;
+    for (int i = 0; i < n; i++) xs[i] = i + 1;
+
+    auto s = clk::now();
+    size_t bad = p.evaluateBatch(xs, batch, overflow);
+    double tBatch = chrono::duration<double, milli>(clk::now() - s).count();
+
+    s = clk::now();
+    for (int i = 0; i < n; i++)
+        if (!p.evaluate(xs[i], single[i])) single[i] = 0;
+    double tSingle = chrono::duration<double, milli>(clk::now() - s).count();
+
+    long long mismatches = 0;
+    for (int i = 0; i < n; i++)
+        if (!overflow[i] && batch[i] != single[i]) mismatches++;
+
+    cout << n << " customers: batch " << tBatch << " ms, one-by-one " << tSingle << " ms, "
+         << bad << " overflowed, " << mismatches << " mismatches\n";
+}
+
 // ------------------------------------------------------------
 // MAIN Customer Support System
 // ------------------------------------------------------------
-int main() {
+// Optional argument: file that backs the undo history (see UndoLog).
+int main(int argc, char* argv[]) {
     TicketList tickets;
-    UndoStack undo;
+    UndoLog undo(1 << 20, argc > 1 ? argv[1] : "");
     PriorityQueue pq;
-    CircularQueue cq;
+    CircularQueue<TicketRef> cq;
     PolyList bill1, bill2;
 
     int choice;
 
     cout << "Customer Support Ticket System\n";
 
+    // Bring back the tickets of earlier runs from a durable log.
+    for (size_t i = 0; i < undo.size(); i++) {
+        const UndoRecord& r = undo[i];
+        if (r.op != UNDO_ADD_TICKET) continue;
+        Ticket* t = tickets.insertTicket(r.id, recordText(r.name), recordText(r.issue), r.priority, false);
+        if (t != NULL) {
+            pq.enqueue(t);
+            cq.enqueue({t, t->serial});
+        }
+    }
+    if (undo.size() > 0) cout << "Restored " << undo.size() << " ticket(s) from the undo log.\n";
+
     while (true) {
         cout << "\nMenu:\n";
         cout << "1. Add Ticket\n";
@@ -236,6 +1045,12 @@ int main() {
         cout << "6. Enter Billing Records\n";
         cout << "7. Compare Billing\n";
         cout << "8. Display Ticket List\n";
+        cout << "9. Escalate Ticket Priority\n";
+        cout << "10. Benchmark Priority Queue\n";
+        cout << "11. Stress Test Round-Robin Queue\n";
+        cout << "12. Search Tickets by Keyword\n";
+        cout << "13. Batch Evaluate Bill 1\n";
+        cout << "14. Combine Bills\n";
         cout << "0. Exit\n";
         cout << "Enter choice: ";
         cin >> choice;
@@ -251,21 +1066,27 @@ int main() {
             cout << "Issue: "; cin >> issue;
             cout << "Priority (1=urgent): "; cin >> p;
 
-            tickets.insertTicket(id, name, issue, p);
+            // keep the ticket identical to what the undo log can restore
+            UndoRecord rec = addTicketRecord(id, name, issue, p);
+            if (name.size() >= UNDO_TEXT || issue.size() >= UNDO_TEXT)
+                cout << "Name/issue cut to " << UNDO_TEXT - 1 << " characters.\n";
 
-            undo.push(id);
-
-            Ticket* t = tickets.search(id);
-            pq.enqueue(t);
-            cq.enqueue(t);
+            Ticket* t = tickets.insertTicket(id, recordText(rec.name), recordText(rec.issue), p);
+            if (t != NULL) {
+                undo.push(rec);
+                pq.enqueue(t);
+                cq.enqueue({t, t->serial});
+            }
         }
 
         else if (choice == 2) {
-            int last = undo.pop();
-            if (last == -1)
+            // Deleting the ticket changes its serial, which invalidates
+            // its entries in both queues without touching them.
+            UndoRecord r;
+            if (!undo.pop(r))
                 cout << "Nothing to undo.\n";
-            else
-                tickets.deleteTicket(last);
+            else if (r.op == UNDO_ADD_TICKET)
+                tickets.deleteTicket(r.id);
         }
 
         else if (choice == 3) {
@@ -286,11 +1107,12 @@ int main() {
         }
 
         else if (choice == 5) {
-            Ticket* t = cq.dequeue();
-            if (t == NULL) cout << "No tickets.\n";
+            TicketRef r = cq.dequeue();
+            while (r.t != NULL && !r.live()) r = cq.dequeue();  // drop undone tickets
+            if (r.t == NULL) cout << "No tickets.\n";
             else {
-                cout << "Round Robin Processing Ticket: " << t->id << endl;
-                cq.enqueue(t);
+                cout << "Round Robin Processing Ticket: " << r.t->id << endl;
+                cq.enqueue(r);
             }
         }
 
@@ -299,33 +1121,78 @@ int main() {
             cout << "Enter 3 terms for Bill 1 (coeff exp):\n";
             for (int i = 0; i < 3; i++) {
                 cin >> c >> e;
-                bill1.insertTerm(c, e);
+                if (!bill1.insertTerm(c, e)) cout << "Term overflows 64 bits; skipped.\n";
             }
             cout << "Enter 3 terms for Bill 2:\n";
             for (int i = 0; i < 3; i++) {
                 cin >> c >> e;
-                bill2.insertTerm(c, e);
+                if (!bill2.insertTerm(c, e)) cout << "Term overflows 64 bits; skipped.\n";
             }
         }
 
         else if (choice == 7) {
-            int x;
-            cout << "Enter x: ";
-            cin >> x;
-
-            int v1 = bill1.evaluate(x);
-            int v2 = bill2.evaluate(x);
+            cout << "Bill1 = " << bill1.toString() << endl;
+            cout << "Bill2 = " << bill2.toString() << endl;
 
-            cout << "Bill1 = " << v1 << endl;
-            cout << "Bill2 = " << v2 << endl;
-
-            if (v1 == v2) cout << "Bills are equal.\n";
-            else cout << "Bills differ.\n";
+            PolyList diff;
+            if (bill1 == bill2) cout << "Bills are equal.\n";
+            else if (!PolyList::combine(bill1, bill2, -1, diff)) cout << "Bills differ by more than 64 bits hold.\n";
+            else cout << "Bills differ by " << diff.toString() << endl;
         }
 
         else if (choice == 8) {
             tickets.display();
         }
+
+        else if (choice == 9) {
+            int id, p;
+            cout << "Enter ID: ";
+            cin >> id;
+            cout << "New priority: ";
+            cin >> p;
+            Ticket* t = tickets.search(id);
+            if (t == NULL || !pq.updatePriority(t->pqHandle, p))
+                cout << "Ticket not waiting in priority queue.\n";
+            else
+                cout << "Priority updated.\n";
+        }
+
+        else if (choice == 10) {
+            benchmarkPriorityQueue();
+        }
+
+        else if (choice == 11) {
+            int producers, consumers;
+            cout << "Producers Consumers: ";
+            cin >> producers >> consumers;
+            if (producers < 1 || consumers < 1) cout << "Need at least one of each.\n";
+            else stressCircularQueue(producers, consumers, 2000000);
+        }
+
+        else if (choice == 12) {
+            string text;
+            cout << "Keywords: ";
+            getline(cin >> ws, text);
+            vector<Ticket*> found = tickets.searchKeywords(text);
+            if (found.empty()) cout << "No matching tickets.\n";
+            for (Ticket* t : found)
+                cout << "ID: " << t->id << ", Name: " << t->name << ", Issue: " << t->issue << "\n";
+        }
+
+        else if (choice == 13) {
+            int n;
+            cout << "Number of customers: ";
+            cin >> n;
+            if (n > 0) benchmarkBatchBilling(bill1, n);
+        }
+
+        else if (choice == 14) {
+            PolyList sum, product;
+            if (PolyList::combine(bill1, bill2, 1, sum)) cout << "Bill1 + Bill2 = " << sum.toString() << endl;
+            else cout << "Bill1 + Bill2 overflows 64 bits.\n";
+            if (multiplyBills(bill1, bill2, product)) cout << "Bill1 * Bill2 = " << product.toString() << endl;
+            else cout << "Bill1 * Bill2 overflows 64 bits.\n";
+        }
     }
 
     return 0;
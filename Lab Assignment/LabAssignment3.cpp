@@ -1,6 +1,15 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <climits>
+#include "../Common/SortEngine.h"
 using namespace std;
 
 // -------------------------------------------------------
@@ -13,12 +22,18 @@ struct Student {
     string course;
 };
 
+// The searches and sorts below read keys through these, so they also run
+// on wrapped records (see the benchmark harness).
+inline float gradeOf(const Student& s) { return s.grade; }
+inline int idOf(const Student& s) { return s.id; }
+
 // -------------------------------------------------------
 // 1. Sequential Search
 // -------------------------------------------------------
-int sequentialSearch(vector<Student>& arr, int key) {
-    for (int i = 0; i < arr.size(); i++)
-        if (arr[i].id == key)
+template <typename T>
+int sequentialSearch(vector<T>& arr, int key) {
+    for (int i = 0; i < (int)arr.size(); i++)
+        if (idOf(arr[i]) == key)
             return i;
     return -1;
 }
@@ -26,13 +41,14 @@ int sequentialSearch(vector<Student>& arr, int key) {
 // -------------------------------------------------------
 // 2. Binary Search (array must be sorted by ID)
 // -------------------------------------------------------
-int binarySearch(vector<Student>& arr, int key) {
+template <typename T>
+int binarySearch(vector<T>& arr, int key) {
     int l = 0, r = arr.size() - 1;
 
     while (l <= r) {
         int mid = (l + r) / 2;
-        if (arr[mid].id == key) return mid;
-        if (arr[mid].id < key) l = mid + 1;
+        if (idOf(arr[mid]) == key) return mid;
+        if (idOf(arr[mid]) < key) l = mid + 1;
         else r = mid - 1;
     }
     return -1;
@@ -41,21 +57,24 @@ int binarySearch(vector<Student>& arr, int key) {
 // -------------------------------------------------------
 // 3. Bubble Sort (sort by grade)
 // -------------------------------------------------------
-void bubbleSort(vector<Student>& arr) {
-    for (int i = 0; i < arr.size() - 1; i++)
-        for (int j = 0; j < arr.size() - i - 1; j++)
-            if (arr[j].grade > arr[j + 1].grade)
+template <typename T>
+void bubbleSort(vector<T>& arr) {
+    int n = arr.size();
+    for (int i = 0; i < n - 1; i++)
+        for (int j = 0; j < n - i - 1; j++)
+            if (gradeOf(arr[j]) > gradeOf(arr[j + 1]))
                 swap(arr[j], arr[j + 1]);
 }
 
 // -------------------------------------------------------
 // 4. Insertion Sort (sort by grade)
 // -------------------------------------------------------
-void insertionSort(vector<Student>& arr) {
-    for (int i = 1; i < arr.size(); i++) {
-        Student key = arr[i];
+template <typename T>
+void insertionSort(vector<T>& arr) {
+    for (int i = 1; i < (int)arr.size(); i++) {
+        T key = arr[i];
         int j = i - 1;
-        while (j >= 0 && arr[j].grade > key.grade) {
+        while (j >= 0 && gradeOf(arr[j]) > gradeOf(key)) {
             arr[j+1] = arr[j];
             j--;
         }
@@ -66,77 +85,44 @@ void insertionSort(vector<Student>& arr) {
 // -------------------------------------------------------
 // 5. Merge Sort (sort by grade)
 // -------------------------------------------------------
-void merge(vector<Student>& arr, int l, int m, int r) {
-    vector<Student> L, R;
-    for (int i = l; i <= m; i++) L.push_back(arr[i]);
-    for (int i = m+1; i <= r; i++) R.push_back(arr[i]);
-
-    int i = 0, j = 0, k = l;
-
-    while (i < L.size() && j < R.size()) {
-        if (L[i].grade <= R[j].grade)
-            arr[k++] = L[i++];
-        else
-            arr[k++] = R[j++];
-    }
-    while (i < L.size()) arr[k++] = L[i++];
-    while (j < R.size()) arr[k++] = R[j++];
-}
-
-void mergeSort(vector<Student>& arr, int l, int r) {
-    if (l < r) {
-        int m = (l+r)/2;
-        mergeSort(arr, l, m);
-        mergeSort(arr, m+1, r);
-        merge(arr, l, m, r);
-    }
+// Stable natural merge sort from SortEngine.h, keyed on grade.
+template <typename T>
+void mergeSort(vector<T>& arr, int l, int r) {
+    mergeSortBy(arr, l, r, [](const T& a, const T& b) { return gradeOf(a) < gradeOf(b); });
 }
 
 // -------------------------------------------------------
 // 6. Quick Sort (sort by grade)
 // -------------------------------------------------------
-int partition(vector<Student>& arr, int low, int high) {
-    float pivot = arr[high].grade;
-    int i = low - 1;
-
-    for (int j = low; j < high; j++) {
-        if (arr[j].grade < pivot) {
-            i++;
-            swap(arr[i], arr[j]);
-        }
-    }
-    swap(arr[i+1], arr[high]);
-    return i + 1;
-}
-
-void quickSort(vector<Student>& arr, int low, int high) {
-    if (low < high) {
-        int pi = partition(arr, low, high);
-        quickSort(arr, low, pi - 1);
-        quickSort(arr, pi + 1, high);
-    }
+// Introsort from SortEngine.h, keyed on grade.
+template <typename T>
+void quickSort(vector<T>& arr, int low, int high) {
+    if (low < high)
+        introSort(arr, low, high + 1, [](const T& s) { return gradeOf(s); });
 }
 
 // -------------------------------------------------------
 // 7. Heap Sort (rank by performance)
 // -------------------------------------------------------
-void heapify(vector<Student>& arr, int n, int i) {
-    int largest = i;
-    int l = 2*i + 1;
-    int r = 2*i + 2;
-
-    if (l < n && arr[l].grade > arr[largest].grade)
-        largest = l;
-    if (r < n && arr[r].grade > arr[largest].grade)
-        largest = r;
-
-    if (largest != i) {
-        swap(arr[i], arr[largest]);
-        heapify(arr, n, largest);
+// Iterative sift-down: the displaced element is held aside and children
+// move up into the hole, instead of a swap and a recursive call per level.
+template <typename T>
+void heapify(vector<T>& arr, int n, int i) {
+    T item = std::move(arr[i]);
+    while (2*i + 1 < n) {
+        int largest = 2*i + 1;
+        if (largest + 1 < n && gradeOf(arr[largest + 1]) > gradeOf(arr[largest]))
+            largest++;
+        if (!(gradeOf(arr[largest]) > gradeOf(item)))
+            break;
+        arr[i] = std::move(arr[largest]);
+        i = largest;
     }
+    arr[i] = std::move(item);
 }
 
-void heapSort(vector<Student>& arr) {
+template <typename T>
+void heapSort(vector<T>& arr) {
     int n = arr.size();
     for (int i = n/2 - 1; i >= 0; i--)
         heapify(arr, n, i);
@@ -147,49 +133,426 @@ void heapSort(vector<Student>& arr) {
 }
 
 // -------------------------------------------------------
-// 8. Hash Table (Separate Chaining)
+// 8. Hash Table (student ID -> record)
 // -------------------------------------------------------
 class HashTable {
 public:
-    vector<vector<Student>> table;
-    int size = 10;
+    FlatHashTable<int, Student> table;
 
-    HashTable() {
-        table.resize(size);
+    void insertStudent(Student s) {
+        int id = s.id;
+        table.insert(id, std::move(s));
     }
 
-    int hashFunction(int id) {
-        return id % size;
+    Student* search(int id) {
+        return table.find(id);
     }
 
-    void insertStudent(Student s) {
-        int index = hashFunction(s.id);
-        table[index].push_back(s);
-    }
+    FlatHashTable<int, Student>::iterator begin() { return table.begin(); }
+    FlatHashTable<int, Student>::iterator end() { return table.end(); }
 
-    Student* search(int id) {
-        int index = hashFunction(id);
-        for (auto &s : table[index])
-            if (s.id == id)
-                return &s;
-        return NULL;
+    // Pointers to every record, for sorting or scanning without copying
+    // students. Valid until the next insert.
+    vector<Student*> view() {
+        vector<Student*> result;
+        result.reserve(table.size());
+        for (auto &s : table) result.push_back(&s);
+        return result;
     }
 
+    // Deep copy; prefer view() or iterating the table directly.
     vector<Student> getAll() {
-        vector<Student> result;
-        for (auto &bucket : table)
-            for (auto &s : bucket)
-                result.push_back(s);
-        return result;
+        return vector<Student>(table.begin(), table.end());
+    }
+};
+
+// -------------------------------------------------------
+// 9. Sorted ID Index (binary search without re-sorting)
+// -------------------------------------------------------
+// Maps student ID -> position in the student array. The (id, position)
+// pairs are kept sorted by ID as students are added; searches run over a
+// copy laid out in Eytzinger (BFS) order, so the first levels of every
+// search share a few cache lines and the children of a node sit next to
+// each other. The tree is padded to a complete one (2^levels - 1 nodes),
+// which makes every search exactly `levels` branch-free steps. Reordering
+// the array (any sort) only marks the index stale; it is rebuilt on the
+// next lookup.
+class SortedIdIndex {
+    const vector<Student>& students;
+    vector<pair<int, int>> sorted;  // (id, position), ordered by id
+    vector<int> keys;               // Eytzinger order, 1-based
+    vector<int> pos;                // position of keys[k]; -1 for padding
+    int levels = 0;
+    bool sortedStale = false;       // positions no longer match the array
+    bool layoutStale = true;        // keys/pos lag behind sorted
+
+    void fill(size_t k, size_t& next) {
+        if (k >= keys.size()) return;
+        fill(2 * k, next);
+        if (next < sorted.size()) {
+            keys[k] = sorted[next].first;
+            pos[k] = sorted[next].second;
+        } else {
+            keys[k] = INT32_MAX;
+            pos[k] = -1;
+        }
+        next++;
+        fill(2 * k + 1, next);
+    }
+
+    void refresh() {
+        if (sortedStale) {
+            vector<uint32_t> order = sortIndexByKey(students, [](const Student& s) { return s.id; });
+            sorted.resize(order.size());
+            for (size_t i = 0; i < order.size(); i++)
+                sorted[i] = {students[order[i]].id, (int)order[i]};
+            sortedStale = false;
+            layoutStale = true;
+        }
+        if (layoutStale) {
+            levels = 0;
+            while (((size_t)1 << levels) - 1 < sorted.size()) levels++;
+            keys.assign((size_t)1 << levels, 0);
+            pos.assign(keys.size(), -1);
+            size_t next = 0;
+            fill(1, next);
+            layoutStale = false;
+        }
+    }
+
+    // Eytzinger slot of the first key >= id after a full descent from k.
+    static size_t settle(size_t k) { return k >> __builtin_ffsll(~(long long)k); }
+
+public:
+    explicit SortedIdIndex(const vector<Student>& arr) : students(arr) {}
+
+    // students[position] was just appended or changed to this id.
+    void add(int id, int position) {
+        if (sortedStale) return;
+        pair<int, int> e(id, position);
+        sorted.insert(upper_bound(sorted.begin(), sorted.end(), e), e);
+        layoutStale = true;
+    }
+
+    // The array was reordered; positions are rebuilt on the next lookup.
+    void invalidate() { sortedStale = true; }
+
+    // Position of a student with this id, or -1.
+    int find(int id) {
+        refresh();
+        const int* k_ = keys.data();
+        size_t k = 1;
+        for (int l = 0; l < levels; l++) {
+            __builtin_prefetch(k_ + min(k * 16, keys.size() - 1));  // 4 levels ahead
+            k = 2 * k + (k_[k] < id);
+        }
+        k = settle(k);
+        return k != 0 && k_[k] == id ? pos[k] : -1;
+    }
+
+    // out[i] = find(ids[i]). Runs BATCH searches in lockstep so their cache
+    // misses overlap instead of being paid one after another.
+    void findBatch(const int* ids, int* out, size_t m) {
+        refresh();
+        const size_t BATCH = 16;
+        const int* k_ = keys.data();
+        for (size_t base = 0; base < m; base += BATCH) {
+            size_t cnt = min(BATCH, m - base);
+            size_t k[BATCH];
+            for (size_t j = 0; j < cnt; j++) k[j] = 1;
+            for (int l = 0; l < levels; l++)
+                for (size_t j = 0; j < cnt; j++) {
+                    __builtin_prefetch(k_ + min(k[j] * 16, keys.size() - 1));
+                    k[j] = 2 * k[j] + (k_[k[j]] < ids[base + j]);
+                }
+            for (size_t j = 0; j < cnt; j++) {
+                size_t s = settle(k[j]);
+                out[base + j] = s != 0 && k_[s] == ids[base + j] ? pos[s] : -1;
+            }
+        }
+    }
+};
+
+// Lookups per second: binary search over an ID-sorted copy, the Eytzinger
+// index one at a time, and the index in batches.
+void benchmarkIdLookup(int n) {
+    typedef chrono::steady_clock clk;
+    mt19937 rng(17);
+    vector<Student> students(n);
+    for (int i = 0; i < n; i++) students[i] = {(int)(rng() >> 1), "s", (float)(rng() % 100), "CSE"};
+    SortedIdIndex index(students);
+    index.invalidate();
+
+    const int Q = 2000000;
+    vector<int> ids(Q);
+    for (auto &id : ids) id = rng() % 2 ? students[rng() % n].id : (int)(rng() >> 1);
+    vector<Student> byId = students;
+    parallelRadixSort(byId, [](const Student& s) { return s.id; });
+
+    auto perSec = [](clk::time_point s) {
+        return Q / chrono::duration<double>(clk::now() - s).count() / 1e6;
+    };
+    long long hits[3] = {0, 0, 0};
+    auto s = clk::now();
+    for (int id : ids) hits[0] += binarySearch(byId, id) >= 0;
+    double bin = perSec(s);
+
+    index.find(0);  // build outside the timed loops
+    s = clk::now();
+    for (int id : ids) hits[1] += index.find(id) >= 0;
+    double one = perSec(s);
+
+    vector<int> out(Q);
+    s = clk::now();
+    index.findBatch(ids.data(), out.data(), Q);
+    double batch = perSec(s);
+    for (int p : out) hits[2] += p >= 0;
+
+    cout << "\nn | binary search | index | index batched (M lookups/s)\n"
+         << n << " | " << bin << " | " << one << " | " << batch
+         << (hits[0] != hits[1] || hits[1] != hits[2] ? " (mismatch)" : "") << "\n";
+}
+
+// -------------------------------------------------------
+// 10. Course / Grade Indexes (filtered range queries)
+// -------------------------------------------------------
+// (grade, student ID) entries ordered by grade. New entries go to a short
+// unsorted tail; a query merges the tail in once it has grown past
+// TAIL_SCAN and otherwise just scans it, so a range query costs a binary
+// search plus the size of the result.
+class GradeRun {
+    static const size_t TAIL_SCAN = 64;
+    vector<pair<float, int>> run;   // sorted by grade, then ID
+    vector<pair<float, int>> tail;  // recent inserts, unsorted
+
+    void flush() {
+        sort(tail.begin(), tail.end());
+        size_t mid = run.size();
+        run.insert(run.end(), tail.begin(), tail.end());
+        inplace_merge(run.begin(), run.begin() + mid, run.end());
+        tail.clear();
+    }
+
+public:
+    void add(float grade, int id) { tail.push_back({grade, id}); }
+    size_t size() const { return run.size() + tail.size(); }
+
+    // IDs with lo <= grade <= hi, by ascending grade (tail entries last).
+    void range(float lo, float hi, vector<int>& out) {
+        if (tail.size() > TAIL_SCAN) flush();
+        auto it = lower_bound(run.begin(), run.end(), make_pair(lo, INT_MIN));
+        for (; it != run.end() && it->first <= hi; ++it) out.push_back(it->second);
+        for (auto &e : tail)
+            if (e.first >= lo && e.first <= hi) out.push_back(e.second);
     }
 };
 
+// Secondary indexes for "students in course C with grade in [lo, hi]".
+// Course names are dictionary-encoded to small ints; each course keeps its
+// own grade-ordered posting list, so a course + grade query reads only the
+// matching slice of one list, and a grade-only query uses the global list.
+class StudentQueryIndex {
+    unordered_map<string, int> courseCode;
+    vector<string> courseNames;
+    vector<GradeRun> byCourse;  // indexed by course code
+    GradeRun byGrade;
+
+public:
+    void add(const Student& s) {
+        auto it = courseCode.find(s.course);
+        int code;
+        if (it == courseCode.end()) {
+            code = courseNames.size();
+            courseCode[s.course] = code;
+            courseNames.push_back(s.course);
+            byCourse.emplace_back();
+        } else {
+            code = it->second;
+        }
+        byCourse[code].add(s.grade, s.id);
+        byGrade.add(s.grade, s.id);
+    }
+
+    // IDs of students in course (empty = any) with lo <= grade <= hi.
+    vector<int> query(const string& course, float lo, float hi) {
+        vector<int> out;
+        if (course.empty()) {
+            byGrade.range(lo, hi, out);
+        } else {
+            auto it = courseCode.find(course);
+            if (it != courseCode.end()) byCourse[it->second].range(lo, hi, out);
+        }
+        return out;
+    }
+};
+
+// Insert/lookup timings of the flat table against the old 10-bucket
+// chaining table. Chained lookups are sampled since each one walks ~n/10.
+void benchmarkHashTable(int maxN) {
+    struct ChainedTable {
+        vector<vector<Student>> table;
+        int size = 10;
+        ChainedTable() { table.resize(size); }
+        void insertStudent(const Student& s) { table[s.id % size].push_back(s); }
+        Student* search(int id) {
+            for (auto &s : table[id % size])
+                if (s.id == id) return &s;
+            return NULL;
+        }
+    };
+    typedef chrono::steady_clock clk;
+    auto nsPer = [](clk::time_point s, long long ops) {
+        return chrono::duration<double, nano>(clk::now() - s).count() / ops;
+    };
+
+    mt19937 rng(11);
+    cout << "\n      n | flat insert | flat lookup | chain insert | chain lookup (ns/op)\n";
+    for (long long n = 1000; n <= maxN; n *= 10) {
+        vector<Student> students(n);
+        for (int i = 0; i < n; i++) students[i] = {i + 1, "s", (float)(rng() % 100), "CSE"};
+        shuffle(students.begin(), students.end(), rng);
+        long long flatOps = 1000000, chainOps = max(100LL, min(1000000LL, 200000000LL / n));
+        vector<int> probes(flatOps);
+        for (auto &p : probes) p = (int)(rng() % n) + 1;
+        long long hits = 0;
+
+        HashTable flat;
+        auto s = clk::now();
+        for (auto &st : students) flat.insertStudent(st);
+        double fi = nsPer(s, n);
+        s = clk::now();
+        for (long long i = 0; i < flatOps; i++) hits += flat.search(probes[i]) != NULL;
+        double fl = nsPer(s, flatOps);
+
+        ChainedTable chain;
+        s = clk::now();
+        for (auto &st : students) chain.insertStudent(st);
+        double ci = nsPer(s, n);
+        s = clk::now();
+        for (long long i = 0; i < chainOps; i++) hits += chain.search(probes[i]) != NULL;
+        double cl = nsPer(s, chainOps);
+
+        cout << n << " | " << fi << " | " << fl << " | " << ci << " | " << cl
+             << (hits == 0 ? " (no hits)" : "") << "\n";
+    }
+}
+
+// Wall time of each parallel sort on the same n random students for
+// 1, 2, 4, ... threads up to sortThreadCount(), with speedup over 1 thread.
+void benchmarkParallelSort(int n) {
+    typedef chrono::steady_clock clk;
+    mt19937 rng(15);
+    vector<Student> base(n);
+    for (int i = 0; i < n; i++) base[i] = {(int)rng(), "s", (float)(rng() % 1001) / 10, "CSE"};
+
+    int maxThreads = sortThreadCount(), saved = sortThreads;
+    vector<int> counts;
+    for (int t = 1; t < maxThreads; t *= 2) counts.push_back(t);
+    counts.push_back(maxThreads);
+
+    auto byGrade = [](const Student& s) { return s.grade; };
+    auto gradeLess = [](const Student& a, const Student& b) { return a.grade < b.grade; };
+    auto byId = [](const Student& s) { return s.id; };
+    double base1[3] = {0, 0, 0};
+
+    cout << "\nthreads | quick ms | merge ms | radix(ID) ms | speedup q/m/r\n";
+    for (int t : counts) {
+        sortThreads = t;
+        double ms[3];
+        for (int k = 0; k < 3; k++) {
+            vector<Student> arr = base;
+            auto s = clk::now();
+            if (k == 0) parallelQuickSort(arr, byGrade);
+            else if (k == 1) parallelMergeSort(arr, gradeLess);
+            else parallelRadixSort(arr, byId);
+            ms[k] = chrono::duration<double, milli>(clk::now() - s).count();
+            if (t == 1) base1[k] = ms[k];
+        }
+        cout << t << " | " << ms[0] << " | " << ms[1] << " | " << ms[2] << " | "
+             << base1[0] / ms[0] << "/" << base1[1] / ms[1] << "/" << base1[2] / ms[2] << "\n";
+    }
+    sortThreads = saved;
+}
+
+// The Tracked overloads count every key comparison the routines make.
+inline CountedKey<float> gradeOf(const Tracked<Student>& s) { return s.r.grade; }
+inline CountedKey<int> idOf(const Tracked<Student>& s) { return s.r.id; }
+
+int benchmarkMain(int argc, char** argv) {
+    typedef BenchRoutine<Student> Routine;
+    auto grade = [](const auto& s) { return gradeOf(s); };
+    auto gradeLess = [](const auto& a, const auto& b) { return gradeOf(a) < gradeOf(b); };
+    auto id = [](const auto& s) { return (int)idOf(s); };
+
+    vector<Routine> routines = {
+        sortRoutine<Student>("bubbleSort", 20000, [](auto& a) { bubbleSort(a); }),
+        sortRoutine<Student>("insertionSort", 50000, [](auto& a) { insertionSort(a); }),
+        sortRoutine<Student>("mergeSort", LLONG_MAX, [](auto& a) { mergeSort(a, 0, (int)a.size() - 1); }),
+        sortRoutine<Student>("quickSort", LLONG_MAX, [](auto& a) { quickSort(a, 0, (int)a.size() - 1); }),
+        sortRoutine<Student>("heapSort", LLONG_MAX, [](auto& a) { heapSort(a); }),
+        sortRoutine<Student>("parallelQuickSort", LLONG_MAX, [grade](auto& a) { parallelQuickSort(a, grade); }),
+        sortRoutine<Student>("parallelMergeSort", LLONG_MAX, [gradeLess](auto& a) { parallelMergeSort(a, gradeLess); }),
+        sortRoutine<Student>("parallelRadixSort(id)", LLONG_MAX, [id](auto& a) { parallelRadixSort(a, id); }),
+        sortRoutine<Student>("sortIndexByKey", LLONG_MAX, [grade](auto& a) { benchSink += sortIndexByKey(a, grade).size(); }),
+        sortRoutine<Student>("topK(100)", LLONG_MAX, [grade](auto& a) { benchSink += topK(a, 100, grade).size(); }),
+        sortRoutine<Student>("parallelTopK(100)", LLONG_MAX, [grade](auto& a) { benchSink += parallelTopK(a, 100, grade).size(); }),
+        searchRoutine<Student>("sequentialSearch", true, false, id,
+                               [](auto& a, int x) { return sequentialSearch(a, x) >= 0; }),
+        searchRoutine<Student>("binarySearch", false, true, id,
+                               [](auto& a, int x) { return binarySearch(a, x) >= 0; }),
+    };
+
+    Routine hash{"HashTable::search", LLONG_MAX, true, false, nullptr, nullptr};
+    hash.make = [](const vector<Student>& in, const vector<int>& q) {
+        auto ht = make_shared<HashTable>();
+        for (auto &s : in) ht->insertStudent(s);
+        return function<void()>([ht, &q] {
+            long long hits = 0;
+            for (int x : q) hits += ht->search(x) != NULL;
+            benchSink += hits;
+        });
+    };
+    routines.push_back(hash);
+
+    for (int batched = 0; batched < 2; batched++) {
+        Routine ix{batched ? "SortedIdIndex::findBatch" : "SortedIdIndex::find", LLONG_MAX, true, false, nullptr, nullptr};
+        ix.make = [batched](const vector<Student>& in, const vector<int>& q) {
+            auto arr = make_shared<vector<Student>>(in);
+            auto index = make_shared<SortedIdIndex>(*arr);
+            auto out = make_shared<vector<int>>(q.size());
+            index->invalidate();
+            index->find(0);  // build during setup
+            return function<void()>([arr, index, out, &q, batched] {
+                long long hits = 0;
+                if (batched) {
+                    index->findBatch(q.data(), out->data(), q.size());
+                    for (int p : *out) hits += p >= 0;
+                } else {
+                    for (int x : q) hits += index->find(x) >= 0;
+                }
+                benchSink += hits;
+            });
+        };
+        routines.push_back(ix);
+    }
+
+    return runBenchmarks(argc, argv, "LabAssignment3", routines, [](int i, float g) {
+        return Student{i, "student", g, "CSE"};
+    });
+}
+
 // -------------------------------------------------------
 // MENU + MAIN SYSTEM
 // -------------------------------------------------------
-int main() {
+// Run with --bench [options] for the benchmark harness instead of the menu.
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--bench") return benchmarkMain(argc, argv);
+
     HashTable ht;
     vector<Student> studentArray;
+    SortedIdIndex idIndex(studentArray);
+    TopK<float, pair<int, string>> liveTop(100);  // best grades so far, with (ID, name)
+    StudentQueryIndex queryIndex;
 
     while (true) {
         cout << "\n--- Student Performance Tracker ---\n";
@@ -200,8 +563,14 @@ int main() {
         cout << "5. Insertion Sort\n";
         cout << "6. Merge Sort\n";
         cout << "7. Quick Sort\n";
-        cout << "8. Heap Sort (Rank)\n";
+        cout << "8. Top-K Ranking\n";
         cout << "9. Display All Students\n";
+        cout << "10. Benchmark Hash Table\n";
+        cout << "11. Parallel Sort (grade or ID)\n";
+        cout << "12. Benchmark Parallel Sort\n";
+        cout << "13. Set Sort Threads\n";
+        cout << "14. Benchmark ID Lookup\n";
+        cout << "15. Query by Course and Grade Range\n";
         cout << "0. Exit\n";
 
         int choice;
@@ -216,8 +585,17 @@ int main() {
             cout << "Grade: "; cin >> s.grade;
             cout << "Course: "; cin >> s.course;
 
+            // IDs are the key of every index below; a second record with
+            // the same ID would make lookups resolve to the wrong student.
+            if (ht.search(s.id) != NULL) {
+                cout << "ID " << s.id << " already exists.\n";
+                continue;
+            }
             ht.insertStudent(s);
             studentArray.push_back(s);
+            idIndex.add(s.id, (int)studentArray.size() - 1);
+            liveTop.offer(s.grade, {s.id, s.name});
+            queryIndex.add(s);
 
             cout << "Student Added.\n";
         }
@@ -231,43 +609,113 @@ int main() {
         }
 
         else if (choice == 3) {
-            bubbleSort(studentArray); // ensure sorted for binary search
             int id; cout << "Enter ID: "; cin >> id;
 
-            int pos = binarySearch(studentArray, id);
+            int pos = idIndex.find(id);
             if (pos == -1) cout << "Not Found.\n";
             else cout << "Found: " << studentArray[pos].name << endl;
         }
 
         else if (choice == 4) {
             bubbleSort(studentArray);
+            idIndex.invalidate();
             cout << "Bubble Sort Done.\n";
         }
 
         else if (choice == 5) {
             insertionSort(studentArray);
+            idIndex.invalidate();
             cout << "Insertion Sort Done.\n";
         }
 
         else if (choice == 6) {
             mergeSort(studentArray, 0, studentArray.size()-1);
+            idIndex.invalidate();
             cout << "Merge Sort Done.\n";
         }
 
         else if (choice == 7) {
             quickSort(studentArray, 0, studentArray.size()-1);
+            idIndex.invalidate();
             cout << "Quick Sort Done.\n";
         }
 
         else if (choice == 8) {
-            heapSort(studentArray);
-            cout << "Heap Sort Ranking Done.\n";
+            int k; cout << "How many (K): "; cin >> k;
+            if (k <= 0) continue;
+
+            if ((size_t)k <= liveTop.capacity()) {
+                // answered from the board kept up to date on every add; it
+                // carries what it prints, so no lookup by (possibly shared) ID
+                auto board = liveTop.ranked();
+                for (int i = 0; i < k && i < (int)board.size(); i++)
+                    cout << i + 1 << ". " << board[i].second.first << " " << board[i].second.second << " "
+                         << board[i].first << endl;
+            } else {
+                vector<uint32_t> best = parallelTopK(studentArray, k, [](const Student& st) { return st.grade; });
+                for (size_t i = 0; i < best.size(); i++) {
+                    const Student& st = studentArray[best[i]];
+                    cout << i + 1 << ". " << st.id << " " << st.name << " " << st.grade << endl;
+                }
+            }
         }
 
         else if (choice == 9) {
             for (auto &s : studentArray)
                 cout << s.id << " " << s.name << " " << s.grade << endl;
         }
+
+        else if (choice == 10) {
+            int n;
+            cout << "Max students: ";
+            cin >> n;
+            benchmarkHashTable(n);
+        }
+
+        else if (choice == 11) {
+            int by;
+            cout << "Sort by (1 = grade, 2 = ID): ";
+            cin >> by;
+            if (by == 2) parallelRadixSort(studentArray, [](const Student& s) { return s.id; });
+            else parallelMergeSort(studentArray, [](const Student& a, const Student& b) { return a.grade < b.grade; });
+            idIndex.invalidate();
+            cout << "Parallel Sort Done (" << sortThreadCount() << " threads).\n";
+        }
+
+        else if (choice == 12) {
+            int n;
+            cout << "Students: ";
+            cin >> n;
+            benchmarkParallelSort(n);
+        }
+
+        else if (choice == 13) {
+            cout << "Threads (0 = all cores): ";
+            cin >> sortThreads;
+        }
+
+        else if (choice == 14) {
+            int n;
+            cout << "Students: ";
+            cin >> n;
+            if (n < 1) cout << "Invalid size.\n";
+            else benchmarkIdLookup(n);
+        }
+
+        else if (choice == 15) {
+            string course;
+            float lo, hi;
+            cout << "Course (* for any): "; cin >> course;
+            cout << "Min grade: "; cin >> lo;
+            cout << "Max grade: "; cin >> hi;
+
+            vector<int> ids = queryIndex.query(course == "*" ? "" : course, lo, hi);
+            for (int id : ids) {
+                const Student& st = studentArray[idIndex.find(id)];
+                cout << st.id << " " << st.name << " " << st.course << " " << st.grade << endl;
+            }
+            cout << ids.size() << " student(s) matched.\n";
+        }
     }
 
     return 0;
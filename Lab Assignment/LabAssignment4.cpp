@@ -4,10 +4,14 @@
 #include <queue>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include "../Common/GraphEngine.h"
 using namespace std;
 
-const int INF = 1e9;
-
 /*---------------------------------------------
     BUILDING DATA NODE (BST / AVL)
 ----------------------------------------------*/
@@ -140,6 +144,416 @@ void postorder(Building *root)
     cout << root->id << " - " << root->name << " - " << root->location << endl;
 }
 
+/*---------------------------------------------
+    A* HEURISTIC AND BIDIRECTIONAL SEARCH
+----------------------------------------------*/
+// Straight-line distance to the target in weight units. scale is the
+// lowest weight per unit of length over all edges, so h(u) <= w + h(v) on
+// every edge u -> v and A* stays exact while stopping at the target.
+struct EuclideanHeuristic
+{
+    const CsrGraph *g;
+    double scale;
+    float tx, ty;
+
+    EuclideanHeuristic(const CsrGraph &graph, double s, int target)
+        : g(&graph), scale(s), tx(graph.x[target]), ty(graph.y[target]) {}
+
+    int operator()(int v) const
+    {
+        float dx = g->x[v] - tx, dy = g->y[v] - ty;
+        return (int)(scale * sqrt(dx * dx + dy * dy));
+    }
+};
+
+double heuristicScale(const CsrGraph &g)
+{
+    double scale = -1;
+    for (int u = 1; u <= g.n; u++)
+        for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
+        {
+            int v = g.targets[i];
+            double len = hypot(g.x[u] - g.x[v], g.y[u] - g.y[v]);
+            if (len > 0 && (scale < 0 || g.weights[i] / len < scale))
+                scale = g.weights[i] / len;
+        }
+    return scale < 0 ? 0 : scale * (1 - 1e-6); // margin for rounding
+}
+
+// Dijkstra from both ends at once, always advancing the side with the
+// smaller frontier. bwd is the reverse graph (the same CSR for undirected
+// graphs). best is the shortest source-meet-target path seen so far; the
+// search stops once the two frontiers together cannot beat it.
+class BidirectionalSearch
+{
+public:
+    int settled = 0;
+
+    int run(const CsrGraph &fwd, const CsrGraph &bwd, int source, int target)
+    {
+        const CsrGraph *graph[2] = {&fwd, &bwd};
+        side[0].start(fwd, source);
+        side[1].start(bwd, target);
+        best = INF;
+        meet = 0;
+        meetAt(source);
+
+        while (!side[0].exhausted() && !side[1].exhausted())
+        {
+            uint32_t f = side[0].frontier(), b = side[1].frontier();
+            if ((long long)f + b >= best)
+                break;
+            int s = f <= b ? 0 : 1;
+            int u = side[s].settleNext(*graph[s]);
+            if (u == 0)
+                break;
+            for (int i = graph[s]->offsets[u]; i < graph[s]->offsets[u + 1]; i++)
+                meetAt(graph[s]->targets[i]);
+        }
+        settled = side[0].settled + side[1].settled;
+        return best;
+    }
+
+    // Nodes from the source to the target, or empty if there is no path.
+    vector<int> path() const
+    {
+        if (best == INF)
+            return {};
+        vector<int> p = side[0].path(meet), back = side[1].path(meet);
+        p.insert(p.end(), back.rbegin() + 1, back.rend());
+        return p;
+    }
+
+private:
+    ShortestPaths side[2];
+    int best = INF, meet = 0;
+
+    void meetAt(int v)
+    {
+        long long d = (long long)side[0].distance(v) + side[1].distance(v);
+        if (d < best)
+        {
+            best = (int)d;
+            meet = v;
+        }
+    }
+};
+
+/*---------------------------------------------
+    CONTRACTION HIERARCHY
+----------------------------------------------*/
+// Offline index for point-to-point distances on undirected graphs. Nodes
+// are contracted one at a time, least important first. Removing a node
+// adds a shortcut between two of its neighbours unless a witness path
+// between them avoids it. Afterwards every shortest path climbs to a
+// single highest-ranked node and descends again, so a query only follows
+// edges to higher ranks, from both ends. Queries return distances;
+// shortcuts are not unpacked into paths.
+
+// Order-independent fingerprint of a graph: one mixed value per building
+// and per directed edge, summed, so it can be kept up to date as the graph
+// grows. A hierarchy records the fingerprint of the graph it was built
+// from and is only used while the graph still has that fingerprint.
+static uint64_t mix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t nodeHash(int u) { return mix64((uint64_t)(uint32_t)u); }
+
+static uint64_t edgeHash(int u, int v, int w)
+{
+    return mix64(((uint64_t)(uint32_t)u << 32 | (uint32_t)v) ^ mix64((uint64_t)(uint32_t)w));
+}
+
+struct ContractionHierarchy
+{
+    vector<int> rank;    // contraction order of each node
+    CsrGraph up;         // edges to higher-ranked nodes, shortcuts included
+    uint64_t source = 0; // fingerprint of the graph it was built from
+
+    bool save(const string &file) const
+    {
+        ofstream out(file, ios::binary);
+        int m = up.edgeCount();
+        out.write("CH02", 4);
+        out.write((const char *)&up.n, sizeof(int));
+        out.write((const char *)&m, sizeof(int));
+        out.write((const char *)&source, sizeof(source));
+        for (const vector<int> *a : {&rank, &up.offsets, &up.targets, &up.weights})
+            out.write((const char *)a->data(), a->size() * sizeof(int));
+        return (bool)out;
+    }
+
+    // Leaves the hierarchy unchanged if the file is missing or malformed.
+    bool load(const string &file)
+    {
+        ifstream in(file, ios::binary | ios::ate);
+        long long bytes = in ? (long long)in.tellg() : 0;
+        in.seekg(0);
+        char magic[4];
+        int n = -1, m = -1;
+        uint64_t source = 0;
+        in.read(magic, 4);
+        in.read((char *)&n, sizeof(int));
+        in.read((char *)&m, sizeof(int));
+        in.read((char *)&source, sizeof(source));
+        if (!in || string(magic, 4) != "CH02" || n < 0 || m < 0 ||
+            bytes != 20 + 4 * (2LL * n + 3 + 2LL * m))
+            return false;
+
+        ContractionHierarchy ch;
+        ch.source = source;
+        ch.rank.resize(n + 1);
+        ch.up.n = n;
+        ch.up.offsets.resize(n + 2);
+        ch.up.targets.resize(m);
+        ch.up.weights.resize(m);
+        for (vector<int> *a : {&ch.rank, &ch.up.offsets, &ch.up.targets, &ch.up.weights})
+            in.read((char *)a->data(), a->size() * sizeof(int));
+        if (!in || ch.up.offsets[0] != 0 || ch.up.offsets[n + 1] != m)
+            return false;
+        for (int u = 0; u <= n; u++)
+            if (ch.up.offsets[u] > ch.up.offsets[u + 1])
+                return false;
+        for (int i = 0; i < m; i++)
+            if (ch.up.targets[i] < 1 || ch.up.targets[i] > n || ch.up.weights[i] < 0)
+                return false;
+        *this = std::move(ch);
+        return true;
+    }
+};
+
+// Contracts nodes in order of priority: twice the edge difference
+// (shortcuts added minus edges removed), plus the number of neighbours
+// already contracted and the node's depth in the hierarchy so far. The
+// last two terms spread contraction evenly over the graph. Priorities are
+// updated lazily: a popped node is re-scored and pushed back if it is no
+// longer the cheapest, otherwise the shortcuts just found are added.
+class ChBuilder
+{
+public:
+    int shortcuts = 0;
+
+    ContractionHierarchy build(const CsrGraph &g)
+    {
+        int n = g.n;
+        adj.assign(n + 1, {});
+        for (int u = 1; u <= n; u++)
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
+                if (g.targets[i] != u)
+                    link(u, g.targets[i], g.weights[i]);
+        deleted.assign(n + 1, 0);
+        level.assign(n + 1, 0);
+        dist.assign(n + 1, 0);
+        stamp.assign(n + 1, 0);
+        target.assign(n + 1, 0);
+        shortcuts = 0;
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+        for (int v = 1; v <= n; v++)
+            order.push({priority(v), v});
+
+        ContractionHierarchy ch;
+        ch.rank.assign(n + 1, 0);
+        GraphBuilder up;
+        for (int v = 1; v <= n; v++)
+            up.addNode();
+        int next = 0;
+        while (!order.empty())
+        {
+            int v = order.top().second;
+            order.pop();
+            if (ch.rank[v])
+                continue;
+            int p = priority(v);
+            if (!order.empty() && p > order.top().first)
+            {
+                order.push({p, v});
+                continue;
+            }
+
+            ch.rank[v] = ++next;
+            for (auto &e : pending)
+            {
+                link(e.u, e.v, e.w);
+                link(e.v, e.u, e.w);
+            }
+            shortcuts += (int)pending.size();
+            for (auto &e : adj[v]) // the remaining neighbours all rank higher
+            {
+                up.addEdge(v, e.first, e.second);
+                unlink(e.first, v);
+                deleted[e.first]++;
+                level[e.first] = max(level[e.first], level[v] + 1);
+            }
+            adj[v].clear();
+        }
+        ch.up = freeze(up);
+        ch.up.x.clear();
+        ch.up.y.clear();
+        return ch;
+    }
+
+private:
+    static const int WITNESS_SETTLE_LIMIT = 250;
+
+    vector<vector<pair<int, int>>> adj; // the graph not yet contracted
+    vector<int> deleted;                // contracted neighbours per node
+    vector<int> level;                  // longest upward chain below a node
+    vector<GraphBuilder::Edge> pending; // shortcuts for the last node scored
+    vector<int> dist;
+    vector<uint32_t> stamp, target;
+    uint32_t epoch = 0;
+    vector<pair<int, int>> heap;
+
+    int priority(int v)
+    {
+        findShortcuts(v);
+        return 2 * ((int)pending.size() - (int)adj[v].size()) + deleted[v] + level[v];
+    }
+
+    // Keeps the lighter of parallel edges.
+    void link(int u, int v, int w)
+    {
+        for (auto &e : adj[u])
+            if (e.first == v)
+            {
+                e.second = min(e.second, w);
+                return;
+            }
+        adj[u].push_back({v, w});
+    }
+
+    void unlink(int u, int v)
+    {
+        auto &a = adj[u];
+        for (size_t i = 0; i < a.size(); i++)
+            if (a[i].first == v)
+            {
+                a[i] = a.back();
+                a.pop_back();
+                return;
+            }
+    }
+
+    // Fills pending with the shortcuts needed to remove v: one per pair of
+    // neighbours with no witness path of at most the same length.
+    void findShortcuts(int v)
+    {
+        const vector<pair<int, int>> &nb = adj[v];
+        pending.clear();
+        for (size_t i = 0; i + 1 < nb.size(); i++)
+        {
+            int limit = 0;
+            newEpoch();
+            for (size_t j = i + 1; j < nb.size(); j++)
+            {
+                limit = max(limit, nb[i].second + nb[j].second);
+                target[nb[j].first] = epoch;
+            }
+            witness(nb[i].first, v, limit, (int)(nb.size() - i - 1));
+            for (size_t j = i + 1; j < nb.size(); j++)
+            {
+                int via = nb[i].second + nb[j].second;
+                int w = nb[j].first;
+                if (stamp[w] != epoch || dist[w] > via)
+                    pending.push_back({nb[i].first, w, via});
+            }
+        }
+    }
+
+    void newEpoch()
+    {
+        if (++epoch == 0)
+        {
+            fill(stamp.begin(), stamp.end(), 0);
+            fill(target.begin(), target.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    // Bounded Dijkstra from source that avoids skip, stopping once all
+    // targets are settled. Distances up to limit are exact unless the
+    // settle limit cut the search short, in which case a shortcut may be
+    // added that was not strictly needed.
+    void witness(int source, int skip, int limit, int targets)
+    {
+        heap.clear();
+        stamp[source] = epoch;
+        dist[source] = 0;
+        heap.push_back({0, source});
+        auto later = [](const pair<int, int> &a, const pair<int, int> &b)
+        { return a.first > b.first; };
+        int settled = 0;
+        while (!heap.empty() && settled < WITNESS_SETTLE_LIMIT)
+        {
+            pop_heap(heap.begin(), heap.end(), later);
+            pair<int, int> top = heap.back();
+            heap.pop_back();
+            int u = top.second;
+            if (top.first != dist[u])
+                continue;
+            if (top.first > limit)
+                break;
+            settled++;
+            if (target[u] == epoch && --targets == 0)
+                break;
+            for (auto &e : adj[u])
+            {
+                int x = e.first, d = top.first + e.second;
+                if (x == skip || (stamp[x] == epoch && dist[x] <= d))
+                    continue;
+                stamp[x] = epoch;
+                dist[x] = d;
+                heap.push_back({d, x});
+                push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+};
+
+// Bidirectional Dijkstra over the upward edges. Each side stops once its
+// frontier reaches the best distance through a node both sides settled.
+// The graph is undirected, so a node's upward edges are also its edges
+// from higher ranks, which is what stall-on-demand checks.
+class ChQuery
+{
+public:
+    int settled = 0;
+
+    int distance(const ContractionHierarchy &ch, int source, int target)
+    {
+        side[0].start(ch.up, source);
+        side[1].start(ch.up, target);
+        best = source == target ? 0 : INF;
+        while (true)
+        {
+            bool f = live(0), b = live(1);
+            if (!f && !b)
+                break;
+            int s = f && (!b || side[0].frontier() <= side[1].frontier()) ? 0 : 1;
+            int u = side[s].settleNext(ch.up, NoHeuristic(), true);
+            if (u != 0)
+                best = (int)min<long long>(best, (long long)side[0].distance(u) + side[1].distance(u));
+        }
+        settled = side[0].settled + side[1].settled;
+        return best;
+    }
+
+private:
+    ShortestPaths side[2];
+    int best = INF;
+
+    bool live(int s)
+    {
+        return !side[s].exhausted() && (int)side[s].frontier() < best;
+    }
+};
+
 /*---------------------------------------------
     GRAPH FOR CAMPUS PATHS
 ----------------------------------------------*/
@@ -147,85 +561,195 @@ class Graph
 {
 public:
     int n;
-    vector<vector<pair<int, int>>> adj; // adjacency list
-    vector<vector<int>> mat;            // adjacency matrix
 
+    // size is only a capacity hint; the graph grows as buildings are added.
     Graph(int size = 50)
     {
         n = 0;
-        adj = vector<vector<pair<int, int>>>(size);
-        mat = vector<vector<int>>(size, vector<int>(size, INF));
+        builder.edges.reserve(2 * size);
     }
 
-    void addBuilding()
+    void addBuilding(float x = 0, float y = 0)
     {
-        n++;
-        mat[n][n] = 0;
+        n = builder.addNode(x, y);
+        fingerprint += nodeHash(n);
         cout << "Building " << n << " added to graph.\n";
     }
 
     void addPath(int u, int v, int w)
     {
-        if (u > n || v > n)
+        if (u < 1 || v < 1 || u > n || v > n)
         {
             cout << "Invalid building ID.\n";
             return;
         }
-        adj[u].push_back({v, w});
-        adj[v].push_back({u, w});
-        mat[u][v] = mat[v][u] = w;
+        if (w < 0)
+        {
+            cout << "Path length cannot be negative.\n";
+            return;
+        }
+        builder.addEdge(u, v, w);
+        builder.addEdge(v, u, w);
+        fingerprint += edgeHash(u, v, w) + edgeHash(v, u, w);
         cout << "Path added.\n";
     }
 
+    // The frozen CSR view, rebuilt only after the graph has changed.
+    const CsrGraph &csr()
+    {
+        if (frozen.offsets.empty() || frozen.n != builder.n || frozen.edgeCount() != (int)builder.edges.size())
+        {
+            frozen = freeze(builder);
+            hScale = heuristicScale(frozen);
+        }
+        return frozen;
+    }
+
     void printMatrix()
     {
+        if (n > MATRIX_MAX_NODES)
+        {
+            cout << "Graph has " << n << " buildings; matrix is limited to " << MATRIX_MAX_NODES << ".\n";
+            return;
+        }
+        vector<int> mat = adjacencyMatrix(csr());
         cout << "Adjacency Matrix:\n";
         for (int i = 1; i <= n; i++)
         {
             for (int j = 1; j <= n; j++)
             {
-                if (mat[i][j] == INF)
+                int w = mat[(size_t)i * (n + 1) + j];
+                if (w == INF)
                     cout << "INF ";
                 else
-                    cout << mat[i][j] << " ";
+                    cout << w << " ";
             }
-            cout << endl;
+            cout << '\n';
         }
     }
 
     /*---------------------------------------------
         DIJKSTRA FOR OPTIMAL PATH
     ----------------------------------------------*/
-    void dijkstra(int start)
+    // With target 0 every building is settled and listed; otherwise the
+    // search stops at the target and prints the route taken.
+    void dijkstra(int start, int target = 0)
     {
-        vector<int> dist(n + 1, INF);
-        dist[start] = 0;
-        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-        pq.push({0, start});
-
-        while (!pq.empty())
+        if (start < 1 || start > n || target < 0 || target > n)
         {
-            int d = pq.top().first;
-            int u = pq.top().second;
-            pq.pop();
-
-            if (d != dist[u])
-                continue;
+            cout << "Invalid building ID.\n";
+            return;
+        }
+        sp.run(csr(), start, target);
 
-            for (auto p : adj[u])
+        string out;
+        if (target == 0)
+        {
+            out = "Shortest distances from " + to_string(start) + ":\n";
+            for (int i = 1; i <= n; i++)
             {
-                int v = p.first, w = p.second;
-                if (dist[v] > dist[u] + w)
-                {
-                    dist[v] = dist[u] + w;
-                    pq.push({dist[v], v});
-                }
+                int d = sp.distance(i);
+                out += "To " + to_string(i) + " = " + (d == INF ? "INF" : to_string(d)) + "\n";
             }
         }
+        else if (sp.distance(target) == INF)
+            out = "No path from " + to_string(start) + " to " + to_string(target) + ".\n";
+        else
+        {
+            out = "Shortest distance from " + to_string(start) + " to " + to_string(target) + " = " +
+                  to_string(sp.distance(target)) + "\nPath:";
+            for (int v : sp.path(target))
+                out += (v == start ? " " : " -> ") + to_string(v);
+            out += "\n";
+        }
+        cout << out;
+    }
 
-        cout << "Shortest distances from " << start << ":\n";
-        for (int i = 1; i <= n; i++)
-            cout << "To " << i << " = " << dist[i] << endl;
+    // Point-to-point route by A* (method 1) or bidirectional Dijkstra
+    // (method 2), reporting how many buildings each search settled.
+    void route(int start, int target, int method)
+    {
+        if (start < 1 || start > n || target < 1 || target > n)
+        {
+            cout << "Invalid building ID.\n";
+            return;
+        }
+        const CsrGraph &g = csr();
+        int d, settled;
+        vector<int> p;
+        if (method == 2)
+        {
+            d = bi.run(g, g, start, target);
+            p = bi.path();
+            settled = bi.settled;
+        }
+        else
+        {
+            sp.run(g, start, target, EuclideanHeuristic(g, hScale, target));
+            d = sp.distance(target);
+            p = sp.path(target);
+            settled = sp.settled;
+        }
+
+        string out;
+        if (d == INF)
+            out = "No path from " + to_string(start) + " to " + to_string(target) + ".\n";
+        else
+        {
+            out = "Shortest distance = " + to_string(d) + "\nPath:";
+            for (int v : p)
+                out += (v == start ? " " : " -> ") + to_string(v);
+            out += "\n";
+        }
+        out += "Buildings settled: " + to_string(settled) + "\n";
+        cout << out;
+    }
+
+    // Contracts the current graph and writes the hierarchy to file.
+    void buildRouteIndex(const string &file)
+    {
+        auto t0 = chrono::steady_clock::now();
+        ch = chBuilder.build(csr());
+        ch.source = fingerprint;
+        double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        cout << "Contracted " << n << " buildings in " << sec << " s, adding " << chBuilder.shortcuts << " shortcuts.\n";
+        if (ch.save(file))
+            cout << "Route index saved to " << file << ".\n";
+        else
+            cout << "Could not write " << file << ".\n";
+    }
+
+    void loadRouteIndex(const string &file)
+    {
+        if (ch.load(file))
+            cout << "Route index for " << ch.up.n << " buildings loaded.\n";
+        else
+            cout << "Could not read a route index from " << file << ".\n";
+    }
+
+    // Distance from the contraction hierarchy, which must have been built
+    // from the graph as it is now: a path or building added since then
+    // changes the fingerprint and the index is refused.
+    void fastDistance(int start, int target)
+    {
+        if (ch.up.offsets.empty() || ch.up.n != n || ch.source != fingerprint)
+        {
+            cout << "Route index does not match the current graph; build or load a matching index first.\n";
+            return;
+        }
+        if (start < 1 || start > n || target < 1 || target > n)
+        {
+            cout << "Invalid building ID.\n";
+            return;
+        }
+        auto t0 = chrono::steady_clock::now();
+        int d = chq.distance(ch, start, target);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        if (d == INF)
+            cout << "No path from " << start << " to " << target << ".\n";
+        else
+            cout << "Shortest distance = " << d << "\n";
+        cout << "Settled " << chq.settled << " nodes in " << us << " us.\n";
     }
 
     /*---------------------------------------------
@@ -237,14 +761,15 @@ public:
         {
             int u, v, w;
         };
+        const CsrGraph &g = csr();
         vector<E> edges;
 
         // Collect edges
         for (int u = 1; u <= n; u++)
         {
-            for (auto p : adj[u])
+            for (int i = g.offsets[u]; i < g.offsets[u + 1]; i++)
             {
-                int v = p.first, w = p.second;
+                int v = g.targets[i], w = g.weights[i];
                 if (u < v)
                     edges.push_back({u, v, w});
             }
@@ -287,8 +812,131 @@ public:
 
         cout << "Total MST Cost: " << total << endl;
     }
+
+private:
+    GraphBuilder builder;
+    uint64_t fingerprint = 0; // see edgeHash
+    CsrGraph frozen;
+    double hScale = 0;
+    ShortestPaths sp;
+    BidirectionalSearch bi;
+    ContractionHierarchy ch;
+    ChBuilder chBuilder;
+    ChQuery chq;
 };
 
+/*---------------------------------------------
+    ROUTING BENCHMARK
+----------------------------------------------*/
+// Synthetic side x side campus maps. "grid" is a lattice with unit spacing
+// and weights 10-19. "road" jitters the nodes, drops 15% of the streets,
+// makes streets wind (1-1.5x the straight-line length) and adds highways
+// on every 16th row and column: links 8 cells long at 0.6x the cost,
+// which also makes the A* heuristic weaker.
+GraphBuilder syntheticCampus(bool road, int side, mt19937 &rng)
+{
+    GraphBuilder b;
+    auto id = [side](int r, int c)
+    { return r * side + c + 1; };
+    for (int r = 0; r < side; r++)
+        for (int c = 0; c < side; c++)
+        {
+            float jx = road ? (rng() % 60) / 100.0f - 0.3f : 0;
+            float jy = road ? (rng() % 60) / 100.0f - 0.3f : 0;
+            b.addNode(c + jx, r + jy);
+        }
+
+    auto link = [&](int u, int v, double factor)
+    {
+        double len = hypot(b.x[u] - b.x[v], b.y[u] - b.y[v]);
+        int w = road ? (int)(10 * len * factor) + 1 : 10 + rng() % 10;
+        b.addEdge(u, v, w);
+        b.addEdge(v, u, w);
+    };
+    for (int r = 0; r < side; r++)
+        for (int c = 0; c < side; c++)
+        {
+            if (c + 1 < side && !(road && rng() % 100 < 15))
+                link(id(r, c), id(r, c + 1), 1 + (rng() % 50) / 100.0);
+            if (r + 1 < side && !(road && rng() % 100 < 15))
+                link(id(r, c), id(r + 1, c), 1 + (rng() % 50) / 100.0);
+            if (road && r % 16 == 0 && c + 8 < side)
+                link(id(r, c), id(r, c + 8), 0.6);
+            if (road && c % 16 == 0 && r + 8 < side)
+                link(id(r, c), id(r + 8, c), 0.6);
+        }
+    return b;
+}
+
+// Random point-to-point queries on both map types. Each is answered by a
+// one-to-all Dijkstra (the old behaviour), Dijkstra stopping at the
+// target, A*, bidirectional Dijkstra and the contraction hierarchy; all
+// five must agree.
+void benchmarkRouting(int side, int queries)
+{
+    mt19937 rng(23);
+    for (int road = 0; road <= 1; road++)
+    {
+        CsrGraph g = freeze(syntheticCampus(road, side, rng));
+        double scale = heuristicScale(g);
+        ShortestPaths sp;
+        BidirectionalSearch bi;
+        vector<pair<int, int>> q(queries);
+        for (auto &x : q)
+            x = {1 + (int)(rng() % g.n), 1 + (int)(rng() % g.n)};
+
+        auto t0 = chrono::steady_clock::now();
+        ChBuilder cb;
+        ContractionHierarchy ch = cb.build(g);
+        double prep = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        ChQuery chq;
+
+        const char *names[] = {"Dijkstra one-to-all", "Dijkstra early exit", "A*", "Bidirectional", "CH"};
+        vector<int> expect(queries);
+        bool agree = true;
+        cout << (road ? "Road-like" : "Grid") << " graph: " << g.n << " nodes, " << g.edgeCount() << " edges\n";
+        cout << "  CH preprocessing: " << prep << " s, " << cb.shortcuts << " shortcuts\n";
+        for (int m = 0; m < 5; m++)
+        {
+            long long settled = 0;
+            auto t0 = chrono::steady_clock::now();
+            for (int i = 0; i < queries; i++)
+            {
+                int s = q[i].first, t = q[i].second, d;
+                if (m == 4)
+                {
+                    d = chq.distance(ch, s, t);
+                    settled += chq.settled;
+                }
+                else if (m == 3)
+                {
+                    d = bi.run(g, g, s, t);
+                    settled += bi.settled;
+                }
+                else
+                {
+                    if (m == 0)
+                        sp.run(g, s);
+                    else if (m == 1)
+                        sp.run(g, s, t);
+                    else
+                        sp.run(g, s, t, EuclideanHeuristic(g, scale, t));
+                    d = sp.distance(t);
+                    settled += sp.settled;
+                }
+                if (m == 0)
+                    expect[i] = d;
+                agree = agree && d == expect[i];
+            }
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cout << "  " << names[m] << ": " << settled / max(1, queries) << " settled, "
+                 << ms / max(1, queries) << " ms per query\n";
+        }
+        if (!agree)
+            cout << "  Distance mismatch between methods!\n";
+    }
+}
+
 /*---------------------------------------------
     EXPRESSION TREE (FOR ENERGY BILL EVALUATION)
 ----------------------------------------------*/
@@ -376,6 +1024,11 @@ int main()
         cout << "8. Find Optimal Path (Dijkstra)\n";
         cout << "9. Plan Utility Layout (Kruskal)\n";
         cout << "10. Evaluate Energy Bill (Expression Tree)\n";
+        cout << "11. Route Between Buildings (A* / Bidirectional)\n";
+        cout << "12. Benchmark Routing\n";
+        cout << "13. Build Route Index (Contraction Hierarchy)\n";
+        cout << "14. Load Route Index\n";
+        cout << "15. Fast Distance Query (Route Index)\n";
         cout << "0. Exit\n";
 
         int ch;
@@ -407,7 +1060,12 @@ int main()
             postorder(root);
 
         else if (ch == 5)
-            G.addBuilding();
+        {
+            float x, y;
+            cout << "Coordinates (x y): ";
+            cin >> x >> y;
+            G.addBuilding(x, y);
+        }
         else if (ch == 6)
         {
             int u, v, w;
@@ -421,10 +1079,12 @@ int main()
 
         else if (ch == 8)
         {
-            int start;
+            int start, target;
             cout << "Enter start building: ";
             cin >> start;
-            G.dijkstra(start);
+            cout << "Enter destination (0 = all buildings): ";
+            cin >> target;
+            G.dijkstra(start, target);
         }
 
         else if (ch == 9)
@@ -438,6 +1098,48 @@ int main()
             ExprNode *rootExp = ET.build(postfix);
             cout << "Result = " << ET.eval(rootExp) << endl;
         }
+
+        else if (ch == 11)
+        {
+            int start, target, method;
+            cout << "Enter start and destination buildings: ";
+            cin >> start >> target;
+            cout << "Method (1 = A*, 2 = Bidirectional): ";
+            cin >> method;
+            G.route(start, target, method);
+        }
+
+        else if (ch == 12)
+        {
+            int side, queries;
+            cout << "Grid side (nodes = side^2): ";
+            cin >> side;
+            cout << "Queries: ";
+            cin >> queries;
+            if (side < 1 || queries < 1)
+                cout << "Invalid size.\n";
+            else
+                benchmarkRouting(side, queries);
+        }
+
+        else if (ch == 13 || ch == 14)
+        {
+            string file;
+            cout << "Index file: ";
+            cin >> file;
+            if (ch == 13)
+                G.buildRouteIndex(file);
+            else
+                G.loadRouteIndex(file);
+        }
+
+        else if (ch == 15)
+        {
+            int start, target;
+            cout << "Enter start and destination buildings: ";
+            cin >> start >> target;
+            G.fastDistance(start, target);
+        }
     }
 
     return 0;
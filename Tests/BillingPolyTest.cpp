@@ -0,0 +1,98 @@
+// Checks for the shared billing engine (Common/BillingPoly.h). Build and
+// run from the repository root:
+//     g++ -O2 -std=c++17 Tests/BillingPolyTest.cpp -o billing_test && ./billing_test
+// Prints each failed check and exits nonzero if there was one.
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "../Common/BillingPoly.h"
+using namespace std;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        cout << "FAILED: " << what << "\n";
+        failures++;
+    }
+}
+
+// 2x^200 - 4x^199 + 5 at x = 2 is 5, although x^199 alone does not fit
+// in 128 bits: the power must be skipped while the Horner sum is 0.
+void testCancellingTerms() {
+    BillingPoly p = BillingPoly::fromTerms({{2, 200}, {-4, 199}, {5, 0}});
+    long long v = 0;
+    check(p.evaluate(2, v) && v == 5, "cancelling terms, scalar");
+
+    vector<long long> out;
+    vector<char> overflow;
+    bool ok = p.evaluateBatch({2, 2, 2, 2, 2}, out, overflow) == 0;
+    for (long long x : out) ok = ok && x == 5;
+    check(ok, "cancelling terms, batch");
+}
+
+// Random dense operand: 64+ terms over an exponent range at most twice
+// that, each |coefficient| in [c - c/8, c]. sign > 0 / < 0 fixes every
+// sign, 0 picks them at random.
+BillTerms randomDenseBill(mt19937_64& rng, int count, int low, long long c, int sign) {
+    BillTerms t;
+    int range = count + (int)(rng() % (count + 1));
+    vector<int> exps(range);
+    for (int i = 0; i < range; i++) exps[i] = low + i;
+    swap(exps[1], exps[range - 1]);  // keep both ends of the range populated
+    shuffle(exps.begin() + 2, exps.end(), rng);
+    exps.resize(count);
+    sort(exps.rbegin(), exps.rend());
+    for (int e : exps) {
+        long long v = c - (long long)(rng() % (c / 8 + 1));
+        bool negative = sign < 0 || (sign == 0 && rng() % 2);
+        t.push_back({negative ? -v : v, e});
+    }
+    return t;
+}
+
+// Karatsuba works modulo 2^64 and relies on wrapped intermediates
+// cancelling, so it is compared with the exact 128-bit hash accumulator on
+// dense operands scaled until productBound sits just under 2^63. With
+// equal signs the middle coefficients of the product come close to the
+// bound as well.
+void testKaratsubaMatchesSparse() {
+    mt19937_64 rng(10);
+    for (int trial = 0; trial < 60; trial++) {
+        int countA = 64 + (int)(rng() % 200), countB = 64 + (int)(rng() % 200);
+        int n = min(countA, countB);
+        long long c = (long long)sqrtl((long double)INT64_MAX / n);
+        while ((__int128)n * c * c > INT64_MAX) c--;
+        int sign = trial % 3 == 0 ? 1 : (trial % 3 == 1 ? -1 : 0);
+        BillTerms a = randomDenseBill(rng, countA, (int)(rng() % 50), c, sign);
+        BillTerms b = randomDenseBill(rng, countB, (int)(rng() % 50), c, sign == 0 ? 0 : 1);
+
+        __int128 bound = productBound(a, b);
+        check(bound <= INT64_MAX && bound > INT64_MAX / 2, "operands sit just under the 64-bit bound");
+
+        BillTerms dense, sparse, picked;
+        multiplyDense(a, b, dense);
+        check(multiplySparse(a, b, sparse), "hash-accumulate product fits in 64 bits");
+        check(multiplyTerms(a, b, picked), "multiplyTerms accepts dense operands");
+        sort(dense.begin(), dense.end());
+        sort(sparse.begin(), sparse.end());
+        sort(picked.begin(), picked.end());
+        check(dense == sparse, "Karatsuba matches hash-accumulate");
+        check(picked == sparse, "multiplyTerms matches hash-accumulate");
+
+        if (sign != 0) {
+            unsigned long long peak = 0;
+            for (auto &t : sparse) peak = max(peak, (unsigned long long)llabs(t.first));
+            check(peak > (unsigned long long)INT64_MAX / 4, "same-sign product coefficients near the bound");
+        }
+    }
+}
+
+int main() {
+    testCancellingTerms();
+    testKaratsubaMatchesSparse();
+    if (failures == 0) cout << "All billing checks passed.\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -1,9 +1,10 @@
-```cpp
 #include <iostream>
 #include <string>
 #include <stack>
 #include <vector>
-#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include "../Common/BillingPoly.h"
 using namespace std;
 
 // ----------------- Linked List for Patient Records -----------------
@@ -111,12 +112,26 @@ public:
 };
 
 // ----------------- Polynomial Billing -----------------
-int evaluate_polynomial(vector<pair<int,int>> poly, int x) {
-    int total = 0;
-    for (auto term : poly) {
-        total += term.first * pow(x, term.second);
-    }
-    return total;
+// Terms are (coeff, exp); evaluation goes through BillingPoly (see
+// BillingPoly.h). false means the bill overflows 64 bits.
+BillingPoly compile_polynomial(const vector<pair<int,int>>& poly) {
+    BillTerms terms;
+    for (auto &t : poly) terms.push_back({t.first, t.second});
+    return BillingPoly::fromTerms(terms);
+}
+
+bool evaluate_polynomial(const vector<pair<int,int>>& poly, long long x, long long& result) {
+    return compile_polynomial(poly).evaluate(x, result);
+}
+
+// Same tariff for many customers: normalize once, then evaluate every x
+// with the batch kernel. overflow[i] is set for customers whose bill does
+// not fit in 64 bits.
+vector<long long> evaluate_polynomial_batch(const vector<pair<int,int>>& poly,
+                                            const vector<long long>& xs, vector<char>& overflow) {
+    vector<long long> out;
+    compile_polynomial(poly).evaluateBatch(xs, out, overflow);
+    return out;
 }
 
 // ----------------- Postfix Expression Evaluation (simple, no sstream) -----------------
@@ -169,11 +184,21 @@ int main() {
 
     // Billing
     vector<pair<int,int>> bill = {{5,2}, {3,1}, {2,0}}; // 5x^2 + 3x + 2
-    cout << "Billing Amount: " << evaluate_polynomial(bill, 2) << endl;
+    long long amount;
+    if (evaluate_polynomial(bill, 2, amount))
+        cout << "Billing Amount: " << amount << endl;
+    else
+        cout << "Billing Amount overflows." << endl;
+
+    vector<char> overflow;
+    vector<long long> monthEnd = evaluate_polynomial_batch(bill, {1, 2, 3, 4}, overflow);
+    cout << "Month-end bills:";
+    for (size_t i = 0; i < monthEnd.size(); i++)
+        cout << " " << (overflow[i] ? "overflow" : to_string(monthEnd[i]));
+    cout << endl;
 
     // Inventory using postfix (example only works for single-digit numbers)
     cout << "Inventory Calculation: " << evaluate_postfix("1 2 + 3 *") << endl;
 
     return 0;
 }
-```
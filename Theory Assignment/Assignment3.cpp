@@ -1,6 +1,15 @@
 #include <iostream>
+#include <string>
 #include <chrono>
+#include <random>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <functional>
+#include <climits>
+#include "../Common/SortEngine.h"
 using namespace std;
 
 class Student {
@@ -29,58 +38,62 @@ public:
 
 class HashTable {
 private:
-    int size;
-    vector<vector<Student>> table;
-
-    int hashFunction(int key) {
-        return key % size;
-    }
+    FlatHashTable<int, Student> table;
 
 public:
-    HashTable(int s = 10) {
-        size = s;
-        table.resize(size);
-    }
+    // s is the expected number of students, not a bucket count
+    HashTable(int s = 10) : table(s) {}
 
     void insertStudent(Student s) {
-        int index = hashFunction(s.StudentID);
-        table[index].push_back(s);
+        int id = s.StudentID;
+        table.insert(id, std::move(s));
     }
 
     Student* searchStudent(int roll) {
-        int index = hashFunction(roll);
-        for (auto &st : table[index]) {
-            if (st.StudentID == roll)
-                return &st;
-        }
-        return nullptr;
+        return table.find(roll);
     }
 
-    vector<Student> getAllStudents() {
-        vector<Student> list;
-        for (auto &bucket : table)
-            for (auto &x : bucket)
-                list.push_back(x); 
+    FlatHashTable<int, Student>::iterator begin() { return table.begin(); }
+    FlatHashTable<int, Student>::iterator end() { return table.end(); }
+
+    // Pointers to every student (valid until the next insert); sorting
+    // these moves 8-byte pointers instead of whole records.
+    vector<Student*> view() {
+        vector<Student*> list;
+        list.reserve(table.size());
+        for (auto &x : table) list.push_back(&x);
         return list;
     }
+
+    vector<Student> getAllStudents() {
+        return vector<Student>(table.begin(), table.end());
+    }
 };
 
-Student* sequentialSearch(vector<Student>& list, int roll) {
+// The sorts below work on either records or pointers to records.
+inline float marksOf(const Student& s) { return s.Marks; }
+inline float marksOf(const Student* s) { return s->Marks; }
+inline int rollOf(const Student& s) { return s.StudentID; }
+inline int rollOf(const Student* s) { return s->StudentID; }
+
+template <typename T>
+T* sequentialSearch(vector<T>& list, int roll) {
     for (auto &s : list)
-        if (s.StudentID == roll)
+        if (rollOf(s) == roll)
             return &s;
     return nullptr;
 }
 
-Student* binarySearch(vector<Student>& list, int roll) {
+template <typename T>
+T* binarySearch(vector<T>& list, int roll) {
     int l = 0, r = list.size() - 1;
 
     while (l <= r) {
         int m = (l + r) / 2;
 
-        if (list[m].StudentID == roll)
+        if (rollOf(list[m]) == roll)
             return &list[m];
-        else if (list[m].StudentID < roll)
+        else if (rollOf(list[m]) < roll)
             l = m + 1;
         else
             r = m - 1;
@@ -88,43 +101,31 @@ Student* binarySearch(vector<Student>& list, int roll) {
     return nullptr;
 }
 
-int partitionMarks(vector<Student>& a, int low, int high) {
-    float pivot = a[high].Marks;
-    int i = low - 1;
-
-    for (int j = low; j < high; j++) {
-        if (a[j].Marks < pivot) {
-            i++;
-            swap(a[i], a[j]);
-        }
-    }
-    swap(a[i + 1], a[high]);
-    return i + 1;
-}
-
-void quickSortMarks(vector<Student>& a, int low, int high) {
-    if (low < high) {
-        int pi = partitionMarks(a, low, high);
-        quickSortMarks(a, low, pi - 1);
-        quickSortMarks(a, pi + 1, high);
-    }
+template <typename T>
+void quickSortMarks(vector<T>& a, int low, int high) {
+    if (low < high)
+        introSort(a, low, high + 1, [](const T& x) { return marksOf(x); });
 }
 
-void heapify(vector<Student>& arr, int n, int i) {
-    int largest = i;
-    int l = 2*i + 1;
-    int r = 2*i + 2;
-
-    if (l < n && arr[l].Marks > arr[largest].Marks) largest = l;
-    if (r < n && arr[r].Marks > arr[largest].Marks) largest = r;
-
-    if (largest != i) {
-        swap(arr[i], arr[largest]);
-        heapify(arr, n, largest);
+// Iterative sift-down: the displaced element is held aside and children
+// move up into the hole, instead of a swap and a recursive call per level.
+template <typename T>
+void heapify(vector<T>& arr, int n, int i) {
+    T item = std::move(arr[i]);
+    while (2*i + 1 < n) {
+        int largest = 2*i + 1;
+        if (largest + 1 < n && marksOf(arr[largest + 1]) > marksOf(arr[largest]))
+            largest++;
+        if (!(marksOf(arr[largest]) > marksOf(item)))
+            break;
+        arr[i] = std::move(arr[largest]);
+        i = largest;
     }
+    arr[i] = std::move(item);
 }
 
-void heapSortMarks(vector<Student>& arr) {
+template <typename T>
+void heapSortMarks(vector<T>& arr) {
     int n = arr.size();
 
     for (int i = n / 2 - 1; i >= 0; i--) 
@@ -136,62 +137,154 @@ void heapSortMarks(vector<Student>& arr) {
     }
 }
 
-int getMaxRoll(vector<Student>& arr) {
-    int mx = arr[0].StudentID;
-    for (auto &s : arr)
-        mx = max(mx, s.StudentID);
-    return mx;
-}
-
-void countingSort(vector<Student>& arr, int exp) {
-    int n = arr.size();
-    vector<Student> output(n);
-    int count[10] = {0};
-
-    for (int i = 0; i < n; i++)
-        count[(arr[i].StudentID / exp) % 10]++;
+// Radix keys: 32-bit unsigned values that sort in the same order as the
+// original int / float. Flipping the sign bit orders two's-complement ints;
+// floats also need their magnitude bits inverted when negative.
+inline uint32_t rollKey(int id) { return (uint32_t)id ^ 0x80000000u; }
 
-    for (int i = 1; i < 10; i++)
-        count[i] += count[i - 1];
+inline uint32_t marksKey(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof u);
+    return (u & 0x80000000u) ? ~u : u | 0x80000000u;
+}
 
-    for (int i = n - 1; i >= 0; i--) {
-        int idx = (arr[i].StudentID / exp) % 10;
-        output[count[idx] - 1] = arr[i];
-        count[idx]--;
+// LSD radix sort, one byte per pass, of (key << 32 | index) pairs. All four
+// histograms are built in a single read; a pass whose digit is the same for
+// every element is skipped. Each pass scatters into the other buffer.
+void radixSortPairs(vector<uint64_t>& a) {
+    size_t n = a.size();
+    vector<uint64_t> b(n);
+    vector<array<size_t, 256>> hist(4);
+    for (auto &h : hist) h.fill(0);
+    for (uint64_t x : a)
+        for (int p = 0; p < 4; p++) hist[p][(x >> (32 + 8 * p)) & 0xff]++;
+
+    for (int p = 0; p < 4; p++) {
+        int shift = 32 + 8 * p;
+        if (hist[p][(a[0] >> shift) & 0xff] == n) continue;
+        size_t sum = 0;
+        for (auto &c : hist[p]) {
+            size_t cnt = c;
+            c = sum;
+            sum += cnt;
+        }
+        for (uint64_t x : a) b[hist[p][(x >> shift) & 0xff]++] = x;
+        a.swap(b);
     }
-
-    for (int i = 0; i < n; i++)
-        arr[i] = output[i];
 }
 
-void radixSortRoll(vector<Student>& arr) {
-    int m = getMaxRoll(arr);
-    for (int exp = 1; m / exp > 0; exp *= 10)
-        countingSort(arr, exp);
+// Stable radix sort of arr by bits(x), a radix key as above. Only the
+// 8-byte pairs move during the passes; each record moves once at the end.
+template <typename T, typename KeyBits>
+void radixSortBy(vector<T>& arr, KeyBits bits) {
+    size_t n = arr.size();
+    if (n < 2) return;
+    vector<uint64_t> pairs(n);
+    for (size_t i = 0; i < n; i++) pairs[i] = (uint64_t)bits(arr[i]) << 32 | i;
+    radixSortPairs(pairs);
+
+    vector<T> sorted(n);
+    for (size_t i = 0; i < n; i++) sorted[i] = std::move(arr[(uint32_t)pairs[i]]);
+    arr.swap(sorted);
 }
 
-void compareSortingPerformance(vector<Student> arr) {
-    auto arr1 = arr;
-    auto arr2 = arr;
+template <typename T>
+void radixSortRoll(vector<T>& arr) {
+    radixSortBy(arr, [](const T& x) { return rollKey(rollOf(x)); });
+}
 
-    auto s1 = chrono::high_resolution_clock::now();
-    quickSortMarks(arr1, 0, arr1.size() - 1);
-    auto e1 = chrono::high_resolution_clock::now();
+template <typename T>
+void radixSortMarks(vector<T>& arr) {
+    radixSortBy(arr, [](const T& x) { return marksKey(marksOf(x)); });
+}
 
-    auto s2 = chrono::high_resolution_clock::now();
-    heapSortMarks(arr2);
-    auto e2 = chrono::high_resolution_clock::now();
+// The Tracked overloads count every key comparison the routines make.
+inline CountedKey<float> marksOf(const Tracked<Student>& s) { return s.r.Marks; }
+inline CountedKey<int> rollOf(const Tracked<Student>& s) { return s.r.StudentID; }
+inline uint32_t marksKey(CountedKey<float> k) { return marksKey(k.v); }
+inline uint32_t rollKey(CountedKey<int> k) { return rollKey(k.v); }
+
+int benchmarkMain(int argc, char** argv) {
+    typedef BenchRoutine<Student> Routine;
+    auto marks = [](const auto& s) { return marksOf(s); };
+    auto marksLess = [](const auto& a, const auto& b) { return marksOf(a) < marksOf(b); };
+    auto roll = [](const auto& s) { return (int)rollOf(s); };
+
+    vector<Routine> routines = {
+        sortRoutine<Student>("quickSortMarks", LLONG_MAX, [](auto& a) { quickSortMarks(a, 0, (int)a.size() - 1); }),
+        sortRoutine<Student>("heapSortMarks", LLONG_MAX, [](auto& a) { heapSortMarks(a); }),
+        sortRoutine<Student>("mergeSortBy(marks)", LLONG_MAX, [marksLess](auto& a) { mergeSortBy(a, 0, (int)a.size() - 1, marksLess); }),
+        sortRoutine<Student>("radixSortRoll", LLONG_MAX, [](auto& a) { radixSortRoll(a); }),
+        sortRoutine<Student>("radixSortMarks", LLONG_MAX, [](auto& a) { radixSortMarks(a); }),
+        sortRoutine<Student>("parallelQuickSort", LLONG_MAX, [marks](auto& a) { parallelQuickSort(a, marks); }),
+        sortRoutine<Student>("parallelMergeSort", LLONG_MAX, [marksLess](auto& a) { parallelMergeSort(a, marksLess); }),
+        sortRoutine<Student>("parallelRadixSort(roll)", LLONG_MAX, [roll](auto& a) { parallelRadixSort(a, roll); }),
+        sortRoutine<Student>("sortIndexByKey", LLONG_MAX, [marks](auto& a) { benchSink += sortIndexByKey(a, marks).size(); }),
+        sortRoutine<Student>("topK(100)", LLONG_MAX, [marks](auto& a) { benchSink += topK(a, 100, marks).size(); }),
+        sortRoutine<Student>("parallelTopK(100)", LLONG_MAX, [marks](auto& a) { benchSink += parallelTopK(a, 100, marks).size(); }),
+        searchRoutine<Student>("sequentialSearch", true, false, roll,
+                               [](auto& a, int x) { return sequentialSearch(a, x) != nullptr; }),
+        searchRoutine<Student>("binarySearch", false, true, roll,
+                               [](auto& a, int x) { return binarySearch(a, x) != nullptr; }),
+    };
+
+    Routine hash{"HashTable::searchStudent", LLONG_MAX, true, false, nullptr, nullptr};
+    hash.make = [](const vector<Student>& in, const vector<int>& q) {
+        auto ht = make_shared<HashTable>((int)in.size());
+        for (auto &s : in) ht->insertStudent(s);
+        return function<void()>([ht, &q] {
+            long long hits = 0;
+            for (int x : q) hits += ht->searchStudent(x) != nullptr;
+            benchSink += hits;
+        });
+    };
+    routines.push_back(hash);
+
+    return runBenchmarks(argc, argv, "Assignment3", routines, [](int id, float marks) {
+        return Student(id, "student", marks, "CSE");
+    });
+}
 
-    cout << "\nQuick Sort Time: " 
-         << chrono::duration_cast<chrono::microseconds>(e1 - s1).count() 
-         << " microseconds\n";
+// Median wall time of fn over 5 runs after a warm-up, each on a fresh
+// copy of view (copying a view only copies pointers).
+template <typename F>
+long long medianMicros(const vector<Student*>& view, F fn) {
+    vector<long long> us;
+    for (int r = 0; r <= 5; r++) {
+        auto arr = view;
+        auto s = chrono::steady_clock::now();
+        fn(arr);
+        auto e = chrono::steady_clock::now();
+        if (r > 0) us.push_back(chrono::duration_cast<chrono::microseconds>(e - s).count());
+    }
+    sort(us.begin(), us.end());
+    return us[us.size() / 2];
+}
 
-    cout << "Heap Sort Time: " 
-         << chrono::duration_cast<chrono::microseconds>(e2 - s2).count() 
-         << " microseconds\n";
+// Quick comparison for the demo; run with --bench for the full harness.
+void compareSortingPerformance(const vector<Student*>& view) {
+    typedef vector<Student*> View;
+    auto marks = [](const Student* s) { return s->Marks; };
+    auto marksLess = [](const Student* a, const Student* b) { return a->Marks < b->Marks; };
+    string threads = " (" + to_string(sortThreadCount()) + " threads)";
+    vector<pair<string, function<void(View&)>>> sorts = {
+        {"Quick Sort", [](View& a) { quickSortMarks(a, 0, a.size() - 1); }},
+        {"Heap Sort", [](View& a) { heapSortMarks(a); }},
+        {"Index Sort", [marks](View& a) { benchSink += sortIndexByKey(a, marks).size(); }},
+        {"Radix Sort (Marks)", [](View& a) { radixSortMarks(a); }},
+        {"Parallel Quick Sort" + threads, [marks](View& a) { parallelQuickSort(a, marks); }},
+        {"Parallel Merge Sort", [marksLess](View& a) { parallelMergeSort(a, marksLess); }},
+    };
+
+    cout << "\n";
+    for (auto &st : sorts)
+        cout << st.first << " Time: " << medianMicros(view, st.second) << " microseconds\n";
 }
 
-int main() {
+// Run with --bench [options] for the benchmark harness instead of the demo.
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--bench") return benchmarkMain(argc, argv);
+
     HashTable ht(10);
 
     ht.insertStudent(Student(101, "Amit", 85, "CSE"));
@@ -203,26 +296,32 @@ int main() {
     Student* s = ht.searchStudent(102);
     if (s) cout << s->StudentName << " found with marks " << s->Marks << endl;
 
-    vector<Student> list = ht.getAllStudents();
+    // Each sort below reorders its own view of the table; the students
+    // themselves are never copied.
+    vector<Student*> list = ht.view();
 
     cout << "\nSorting by Marks using Quick Sort:\n";
     quickSortMarks(list, 0, list.size() - 1);
-    for (auto &x : list)
-        cout << x.StudentID << " " << x.Marks << endl;
+    for (auto x : list)
+        cout << x->StudentID << " " << x->Marks << endl;
 
-    list = ht.getAllStudents();
+    list = ht.view();
     cout << "\nSorting by Marks using Heap Sort:\n";
     heapSortMarks(list);
-    for (auto &x : list)
-        cout << x.StudentID << " " << x.Marks << endl;
+    for (auto x : list)
+        cout << x->StudentID << " " << x->Marks << endl;
+
+    list = ht.view();
+    cout << "\nTop 2 by Marks (bounded heap, no full sort):\n";
+    for (uint32_t i : topK(list, 2, [](const Student* x) { return x->Marks; }))
+        cout << list[i]->StudentID << " " << list[i]->Marks << endl;
 
-    list = ht.getAllStudents();
     cout << "\nSorting by Roll Number using Radix Sort:\n";
     radixSortRoll(list);
-    for (auto &x : list)
-        cout << x.StudentID << endl;
+    for (auto x : list)
+        cout << x->StudentID << endl;
 
-    compareSortingPerformance(ht.getAllStudents());
+    compareSortingPerformance(ht.view());
 
     return 0;
 }
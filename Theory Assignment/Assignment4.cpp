@@ -2,136 +2,476 @@
 #include <vector>
 #include <queue>
 #include <limits>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "../Common/GraphEngine.h"
+#if defined(__x86_64__) || defined(__i386__)
+#define FW_X86
+#include <immintrin.h>
+#endif
 using namespace std;
 
-const int INF = 1e9;
+// Prints a matrix built by adjacencyMatrix (see GraphEngine.h).
+void printDense(const vector<int>& mat, int n) {
+    for (int i = 1; i <= n; i++) {
+        for (int j = 1; j <= n; j++) {
+            int w = mat[(size_t)i * (n+1) + j];
+            if (w == INF) cout << "INF ";
+            else cout << w << " ";
+        }
+        cout << '\n';
+    }
+}
 
 // -------------------------------------------------------------
-// 1. GRAPH (Adjacency List + Matrix)
+// ALL-PAIRS ENGINE (Blocked Floyd-Warshall)
+// -------------------------------------------------------------
+// Distances live in one row-major array whose stride is padded to whole
+// FW_TILE x FW_TILE tiles; the padding rows and columns stay INF and never
+// shorten a real path. Round kb of the blocked algorithm relaxes every
+// tile through the nodes of tile kb in three phases:
+//   1. the diagonal tile (kb, kb) on its own,
+//   2. the other tiles of row kb and column kb, which only read tile
+//      (kb, kb) besides themselves, in parallel,
+//   3. all remaining tiles, which only read row and column kb, in
+//      parallel.
+// Sums saturate on their operands: a + b is INF when a or b is INF or the
+// sum reaches INF, and is clamped to -INF below. Both operands lie in
+// [-INF, INF], so the sum itself fits in 32 bits. INF therefore stays
+// exact through negative edges, the inner loop needs no INF branch, and
+// every path shorter than INF keeps its exact length.
+// The tile kernels use AVX2 when the CPU has it, picked at run time, so
+// the default build needs no extra flags.
+const int FW_TILE = 64;
+const int APSP_MAX_NODES = 16384;  // 1 GB per distance matrix
+int apspThreads = 0;               // 0 = one per hardware thread
+
+struct DistanceMatrix {
+    int n = 0;
+    size_t stride = 0;
+    vector<int> d;
+
+    int at(int u, int v) const { return d[(u-1) * stride + (v-1)]; }
+    bool reachable(int u, int v) const { return at(u, v) < INF; }
+};
+
+DistanceMatrix initDistances(const CsrGraph& g) {
+    DistanceMatrix m;
+    m.n = g.n;
+    m.stride = (g.n + FW_TILE - 1) / FW_TILE * FW_TILE;
+    m.d.assign(m.stride * m.stride, INF);
+    for (int u = 1; u <= g.n; u++) {
+        int* row = &m.d[(u-1) * m.stride];
+        row[u-1] = 0;
+        for (int e = g.offsets[u]; e < g.offsets[u+1]; e++)
+            row[g.targets[e]-1] = max(-INF, min(row[g.targets[e]-1], g.weights[e]));
+    }
+    return m;
+}
+
+inline int satAdd(int a, int b) {
+    int s = a + b;
+    return a >= INF || b >= INF || s >= INF ? INF : max(s, -INF);
+}
+
+// c[j] = min(c[j], satAdd(a, b[j])) over one tile row.
+inline void relaxRow(int* c, int a, const int* b) {
+    for (int j = 0; j < FW_TILE; j++) c[j] = min(c[j], satAdd(a, b[j]));
+}
+
+// Plain Floyd-Warshall over one tile, k outermost. c may be the same
+// tile as a or b (phases 1 and 2).
+void fwTile(int* c, const int* a, const int* b, size_t stride) {
+    for (int k = 0; k < FW_TILE; k++)
+        for (int i = 0; i < FW_TILE; i++)
+            relaxRow(c + i * stride, a[i * stride + k], b + k * stride);
+}
+
+// Phase 3: a and b are other tiles, so each row of c can take all FW_TILE
+// relaxations at once while it sits in registers.
+void fwTileIndependent(int* c, const int* a, const int* b, size_t stride) {
+    for (int i = 0; i < FW_TILE; i++)
+        for (int k = 0; k < FW_TILE; k++) relaxRow(c + i * stride, a[i * stride + k], b + k * stride);
+}
+
+#ifdef FW_X86
+// AVX2 versions of the three kernels above. They are compiled for AVX2
+// whatever the build flags and only called when the CPU has it.
+#define FW_AVX2 __attribute__((target("avx2")))
+
+FW_AVX2 inline __m256i satAdd8(__m256i a, const int* b) {
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    __m256i s = _mm256_add_epi32(a, vb);
+    __m256i limit = _mm256_set1_epi32(INF - 1);
+    __m256i over = _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(a, limit), _mm256_cmpgt_epi32(vb, limit)),
+                                   _mm256_cmpgt_epi32(s, limit));
+    s = _mm256_max_epi32(s, _mm256_set1_epi32(-INF));
+    return _mm256_blendv_epi8(s, _mm256_set1_epi32(INF), over);
+}
+
+FW_AVX2 inline void relaxRowAvx2(int* c, int a, const int* b) {
+    __m256i va = _mm256_set1_epi32(a);
+    for (int j = 0; j < FW_TILE; j += 8) {
+        __m256i cj = _mm256_loadu_si256((const __m256i*)(c + j));
+        _mm256_storeu_si256((__m256i*)(c + j), _mm256_min_epi32(cj, satAdd8(va, b + j)));
+    }
+}
+
+FW_AVX2 void fwTileAvx2(int* c, const int* a, const int* b, size_t stride) {
+    for (int k = 0; k < FW_TILE; k++)
+        for (int i = 0; i < FW_TILE; i++)
+            relaxRowAvx2(c + i * stride, a[i * stride + k], b + k * stride);
+}
+
+FW_AVX2 void fwTileIndependentAvx2(int* c, const int* a, const int* b, size_t stride) {
+    for (int i = 0; i < FW_TILE; i++) {
+        int* ci = c + i * stride;
+        const int* ai = a + i * stride;
+        __m256i r[FW_TILE / 8];
+        for (int t = 0; t < FW_TILE / 8; t++) r[t] = _mm256_loadu_si256((const __m256i*)(ci + 8*t));
+        for (int k = 0; k < FW_TILE; k++) {
+            __m256i va = _mm256_set1_epi32(ai[k]);
+            const int* bk = b + k * stride;
+            for (int t = 0; t < FW_TILE / 8; t++) r[t] = _mm256_min_epi32(r[t], satAdd8(va, bk + 8*t));
+        }
+        for (int t = 0; t < FW_TILE / 8; t++) _mm256_storeu_si256((__m256i*)(ci + 8*t), r[t]);
+    }
+}
+#endif
+
+// The tile kernels for the CPU we are running on.
+struct FwKernels {
+    void (*tile)(int*, const int*, const int*, size_t);
+    void (*independent)(int*, const int*, const int*, size_t);
+};
+
+FwKernels fwKernels() {
+#ifdef FW_X86
+    if (__builtin_cpu_supports("avx2")) return {fwTileAvx2, fwTileIndependentAvx2};
+#endif
+    return {fwTile, fwTileIndependent};
+}
+
+// Fixed set of worker threads that stays up for a whole solve, so each
+// tile round only wakes the workers instead of creating them. run()
+// hands out f(0) .. f(count-1) through a shared counter, works on them
+// itself as well, and returns once every item is done.
+class WorkerPool {
+public:
+    explicit WorkerPool(int threads) {
+        for (int t = 1; t < threads; t++) workers.emplace_back([this] { loop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lk(mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : workers) t.join();
+    }
+
+    void run(int count, const function<void(int)>& f) {
+        {
+            lock_guard<mutex> lk(mtx);
+            job = &f;
+            jobCount = count;
+            next = 0;
+            busy = (int)workers.size();
+            round++;
+        }
+        wake.notify_all();
+        drain();
+        unique_lock<mutex> lk(mtx);
+        done.wait(lk, [this] { return busy == 0; });
+    }
+
+private:
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable wake, done;
+    const function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    atomic<int> next{0};
+    int busy = 0;
+    long round = 0;
+    bool stopping = false;
+
+    void drain() {
+        for (int x; (x = next.fetch_add(1)) < jobCount;) (*job)(x);
+    }
+
+    void loop() {
+        long seen = 0;
+        for (;;) {
+            {
+                unique_lock<mutex> lk(mtx);
+                wake.wait(lk, [&] { return stopping || round != seen; });
+                if (stopping) return;
+                seen = round;
+            }
+            drain();
+            lock_guard<mutex> lk(mtx);
+            if (--busy == 0) done.notify_one();
+        }
+    }
+};
+
+void floydWarshallBlocked(DistanceMatrix& m, int threads) {
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    int T = (int)(m.stride / FW_TILE);
+    size_t s = m.stride;
+    auto tile = [&](int bi, int bj) { return m.d.data() + (size_t)bi * FW_TILE * s + (size_t)bj * FW_TILE; };
+    FwKernels fw = fwKernels();
+    WorkerPool pool(min(threads, max(1, (T-1) * (T-1))));
+
+    for (int kb = 0; kb < T; kb++) {
+        int* kk = tile(kb, kb);
+        fw.tile(kk, kk, kk, s);
+
+        // Tiles other than kb, numbered 0 .. T-2.
+        auto other = [kb](int x) { return x < kb ? x : x + 1; };
+        pool.run(2 * (T-1), [&](int x) {
+            int j = other(x % (T-1));
+            if (x < T-1) fw.tile(tile(kb, j), kk, tile(kb, j), s);
+            else fw.tile(tile(j, kb), tile(j, kb), kk, s);
+        });
+        pool.run((T-1) * (T-1), [&](int x) {
+            int i = other(x / (T-1)), j = other(x % (T-1));
+            fw.independent(tile(i, j), tile(i, kb), tile(kb, j), s);
+        });
+    }
+}
+
+// The original triple loop on per-row vectors, kept as the benchmark
+// baseline and correctness reference.
+vector<vector<int>> floydWarshallNaive(const DistanceMatrix& m) {
+    int n = m.n;
+    vector<vector<int>> d(n, vector<int>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) d[i][j] = m.d[i * m.stride + j];
+
+    for (int k = 0; k < n; k++)
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                if (d[i][k] < INF && d[k][j] < INF)
+                    d[i][j] = min(d[i][j], d[i][k] + d[k][j]);
+    return d;
+}
+
+// Random directed graph with `degree` out-edges per node and weights in
+// [lo, hi].
+CsrGraph randomGraph(int n, int degree, int lo, int hi, mt19937& rng) {
+    GraphBuilder b;
+    for (int i = 0; i < n; i++) b.addNode();
+    for (int u = 1; u <= n; u++)
+        for (int e = 0; e < degree; e++) b.addEdge(u, 1 + rng() % n, lo + rng() % (hi - lo + 1));
+    return freeze(b);
+}
+
+// Compares a blocked result with the naive one. Naive entries may exceed
+// INF (it adds two reachable distances without saturating); both sides
+// count anything from INF up as unreachable.
+bool matchesNaive(const DistanceMatrix& m, const vector<vector<int>>& expect) {
+    for (int i = 0; i < (int)expect.size(); i++)
+        for (int j = 0; j < m.n; j++)
+            if (min(m.at(i+1, j+1), INF) != min(expect[i][j], INF)) {
+                cout << "Mismatch at " << i+1 << "," << j+1 << "!\n";
+                return false;
+            }
+    return true;
+}
+
+// Random directed graphs with 8 out-edges per node and weights 1-100,
+// doubling from 256 nodes up to maxN. Every size is timed once per thread
+// count (1, 2, 4, ... up to the hardware) on a matrix rebuilt from the
+// graph, so only one matrix is alive at a time, and the naive loop is
+// timed and cross-checked up to 2048 nodes. A graph with weights of 1e8-3e8
+// is cross-checked first: its shortest paths run from below INF / 2 to
+// past INF, so the saturation rule is exercised at both ends.
+void benchmarkFloydWarshall(int maxN) {
+    mt19937 rng(25);
+    int hw = max(1u, thread::hardware_concurrency());
+    {
+        DistanceMatrix m = initDistances(randomGraph(min(256, maxN), 4, 100000000, 300000000, rng));
+        vector<vector<int>> expect = floydWarshallNaive(m);
+        floydWarshallBlocked(m, hw);
+        if (!matchesNaive(m, expect)) return;
+    }
+    cout << "n,threads,seconds,updates_per_sec,speedup\n";
+    for (int n = min(256, maxN); ; n = min(2 * n, maxN)) {
+        CsrGraph g = randomGraph(n, 8, 1, 100, rng);
+        double cube = (double)n * n * n;
+
+        vector<vector<int>> expect;
+        if (n <= 2048) {
+            auto t0 = chrono::steady_clock::now();
+            expect = floydWarshallNaive(initDistances(g));
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            cout << n << ",naive," << sec << "," << cube / sec << ",\n";
+        }
+
+        double base = 0;
+        for (int t = 1; ; t = min(2 * t, hw)) {
+            DistanceMatrix m = initDistances(g);
+            auto t0 = chrono::steady_clock::now();
+            floydWarshallBlocked(m, t);
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            if (t == 1) base = sec;
+            cout << n << "," << t << "," << sec << "," << cube / sec << "," << base / sec << "\n";
+
+            if (!matchesNaive(m, expect)) return;
+            if (t == hw) break;
+        }
+        if (n == maxN) break;
+    }
+}
+
+// -------------------------------------------------------------
+// GRAPH (CSR, matrix on demand)
 // -------------------------------------------------------------
 class Graph {
 public:
     int n;
-    vector<vector<pair<int,int>>> adj;  // adjacency list
-    vector<vector<int>> mat;            // adjacency matrix
 
+    // size is only a capacity hint; the graph grows as nodes are added.
     Graph(int size = 20) {
         n = 0;
-        mat = vector<vector<int>>(size, vector<int>(size, INF));
-        adj = vector<vector<pair<int,int>>>(size);
+        builder.edges.reserve(2 * size);
     }
 
     void addNode() {
-        n++;
-        mat[n][n] = 0;
+        n = builder.addNode();
         cout << "Node " << n << " added.\n";
     }
 
     void addEdge(int u, int v, int w, bool directed) {
-        if (u > n || v > n) {
+        if (u < 1 || v < 1 || u > n || v > n) {
             cout << "Invalid node.\n";
             return;
         }
-        adj[u].push_back({v, w});
-        mat[u][v] = w;
-
-        if (!directed) {
-            adj[v].push_back({u, w});
-            mat[v][u] = w;
-        }
+        builder.addEdge(u, v, w);
+        if (!directed) builder.addEdge(v, u, w);
+        if (w < 0) negativeEdges = true;
 
         cout << "Edge added.\n";
     }
 
+    // The frozen CSR view, rebuilt only after the graph has changed.
+    const CsrGraph& csr() {
+        if (frozen.offsets.empty() || frozen.n != builder.n ||
+            frozen.edgeCount() != (int)builder.edges.size())
+            frozen = freeze(builder);
+        return frozen;
+    }
+
     void printList() {
+        const CsrGraph& g = csr();
         cout << "Adjacency List:\n";
         for (int i = 1; i <= n; i++) {
             cout << i << ": ";
-            for (auto p : adj[i]) {
-                cout << "(" << p.first << "," << p.second << ") ";
+            for (int e = g.offsets[i]; e < g.offsets[i+1]; e++) {
+                cout << "(" << g.targets[e] << "," << g.weights[e] << ") ";
             }
-            cout << endl;
+            cout << '\n';
         }
     }
 
     void printMatrix() {
-        cout << "Adjacency Matrix:\n";
-        for (int i = 1; i <= n; i++) {
-            for (int j = 1; j <= n; j++) {
-                if (mat[i][j] == INF) cout << "INF ";
-                else cout << mat[i][j] << " ";
-            }
-            cout << endl;
+        if (n > MATRIX_MAX_NODES) {
+            cout << "Graph has " << n << " nodes; matrix is limited to " << MATRIX_MAX_NODES << ".\n";
+            return;
         }
+        cout << "Adjacency Matrix:\n";
+        printDense(adjacencyMatrix(csr()), n);
     }
 
     // ---------------------------------------------------------
     // 2. DIJKSTRA
     // ---------------------------------------------------------
-    void dijkstra(int start) {
-        vector<int> dist(n+1, INF);
-        dist[start] = 0;
-
-        priority_queue<pair<int,int>, vector<pair<int,int>>, greater<pair<int,int>>> pq;
-        pq.push({0, start});
-
-        while (!pq.empty()) {
-            int d = pq.top().first;
-            int u = pq.top().second;
-            pq.pop();
-
-            if (d != dist[u]) continue;
-
-            for (auto p : adj[u]) {
-                int v = p.first;
-                int w = p.second;
-
-                if (dist[v] > dist[u] + w) {
-                    dist[v] = dist[u] + w;
-                    pq.push({dist[v], v});
-                }
+    // With target 0 every node is settled and listed; otherwise the
+    // search stops at the target and prints the path taken.
+    void dijkstra(int start, int target = 0) {
+        if (start < 1 || start > n || target < 0 || target > n) {
+            cout << "Invalid node.\n";
+            return;
+        }
+        if (negativeEdges) {
+            cout << "Dijkstra needs non-negative weights; use Floyd Warshall.\n";
+            return;
+        }
+        sp.run(csr(), start, target);
+
+        string out;
+        if (target == 0) {
+            out = "Dijkstra distances from " + to_string(start) + ":\n";
+            for (int i = 1; i <= n; i++) {
+                int d = sp.distance(i);
+                out += (d == INF ? "INF" : to_string(d)) + " ";
             }
+            out += "\n";
         }
-
-        cout << "Dijkstra distances from " << start << ":\n";
-        for (int i = 1; i <= n; i++) {
-            if (dist[i] == INF) cout << "INF ";
-            else cout << dist[i] << " ";
+        else if (sp.distance(target) == INF) {
+            out = "No path from " + to_string(start) + " to " + to_string(target) + ".\n";
         }
-        cout << endl;
+        else {
+            out = "Distance " + to_string(start) + " -> " + to_string(target) + " = " +
+                  to_string(sp.distance(target)) + "\nPath:";
+            for (int v : sp.path(target)) out += (v == start ? " " : " -> ") + to_string(v);
+            out += "\n";
+        }
+        cout << out;
     }
 
     // ---------------------------------------------------------
     // 3. FLOYD WARSHALL
     // ---------------------------------------------------------
     void floydWarshall() {
-        vector<vector<int>> d = mat;
+        if (n > APSP_MAX_NODES) {
+            cout << "Graph has " << n << " nodes; Floyd Warshall is limited to " << APSP_MAX_NODES << ".\n";
+            return;
+        }
+        DistanceMatrix d = initDistances(csr());
+        floydWarshallBlocked(d, apspThreads);
 
-        for (int k = 1; k <= n; k++)
-            for (int i = 1; i <= n; i++)
-                for (int j = 1; j <= n; j++)
-                    if (d[i][k] < INF && d[k][j] < INF)
-                        d[i][j] = min(d[i][j], d[i][k] + d[k][j]);
+        bool negativeCycle = false;
+        for (int i = 1; i <= n; i++) negativeCycle = negativeCycle || d.at(i, i) < 0;
+        if (negativeCycle) cout << "Negative cycle detected; distances through it are not meaningful.\n";
 
-        cout << "Floyd Warshall matrix:\n";
+        if (n > MATRIX_MAX_NODES) {
+            long long pairs = 0;
+            for (int i = 1; i <= n; i++)
+                for (int j = 1; j <= n; j++) pairs += d.reachable(i, j);
+            cout << "All-pairs distances computed; " << pairs << " of " << (long long)n * n
+                 << " pairs are reachable (matrix too large to print).\n";
+            return;
+        }
+        string out = "Floyd Warshall matrix:\n";
         for (int i = 1; i <= n; i++) {
-            for (int j = 1; j <= n; j++) {
-                if (d[i][j] == INF) cout << "INF ";
-                else cout << d[i][j] << " ";
-            }
-            cout << endl;
+            for (int j = 1; j <= n; j++)
+                out += (d.reachable(i, j) ? to_string(d.at(i, j)) : "INF") + " ";
+            out += "\n";
         }
+        cout << out;
     }
 
     // ---------------------------------------------------------
     // 4. TOPOLOGICAL SORT (KAHN)
     // ---------------------------------------------------------
     void topoSort() {
+        const CsrGraph& g = csr();
         vector<int> indeg(n+1, 0);
 
-        for (int u = 1; u <= n; u++)
-            for (auto p : adj[u])
-                indeg[p.first]++;
+        for (int e = 0; e < g.edgeCount(); e++)
+            indeg[g.targets[e]]++;
 
         queue<int> q;
         for (int i = 1; i <= n; i++)
@@ -142,8 +482,8 @@ public:
             int u = q.front(); q.pop();
             order.push_back(u);
 
-            for (auto p : adj[u]) {
-                int v = p.first;
+            for (int e = g.offsets[u]; e < g.offsets[u+1]; e++) {
+                int v = g.targets[e];
                 if (--indeg[v] == 0)
                     q.push(v);
             }
@@ -163,6 +503,7 @@ public:
     // 5. PRIM’S MST
     // ---------------------------------------------------------
     void primMST() {
+        const CsrGraph& g = csr();
         vector<int> key(n+1, INF);
         vector<bool> used(n+1, false);
 
@@ -178,9 +519,9 @@ public:
             used[u] = true;
             total += key[u];
 
-            for (auto p : adj[u]) {
-                int v = p.first;
-                int w = p.second;
+            for (int e = g.offsets[u]; e < g.offsets[u+1]; e++) {
+                int v = g.targets[e];
+                int w = g.weights[e];
                 if (!used[v] && w < key[v])
                     key[v] = w;
             }
@@ -188,6 +529,12 @@ public:
 
         cout << "MST Cost: " << total << endl;
     }
+
+private:
+    GraphBuilder builder;
+    CsrGraph frozen;
+    ShortestPaths sp;
+    bool negativeEdges = false;
 };
 
 // -------------------------------------------------------------
@@ -235,6 +582,7 @@ int main() {
         cout << "8. Display Zones\n";
         cout << "9. Topological Sort\n";
         cout << "10. Prim MST\n";
+        cout << "11. Benchmark Floyd Warshall\n";
         cout << "0. Exit\n";
 
         int ch;
@@ -256,8 +604,10 @@ int main() {
         else if (ch == 3) G.printList();
         else if (ch == 4) G.printMatrix();
         else if (ch == 5) {
-            int s; cout << "Start: "; cin >> s;
-            G.dijkstra(s);
+            int s, t;
+            cout << "Start: "; cin >> s;
+            cout << "Target (0 = all): "; cin >> t;
+            G.dijkstra(s, t);
         }
         else if (ch == 6) G.floydWarshall();
         else if (ch == 7) {
@@ -269,6 +619,13 @@ int main() {
         else if (ch == 8) inorder(zoneRoot);
         else if (ch == 9) G.topoSort();
         else if (ch == 10) G.primMST();
+        else if (ch == 11) {
+            int maxN;
+            cout << "Largest graph (nodes): ";
+            cin >> maxN;
+            if (maxN < 1 || maxN > APSP_MAX_NODES) cout << "Size must be 1-" << APSP_MAX_NODES << ".\n";
+            else benchmarkFloydWarshall(maxN);
+        }
         else cout << "Invalid.\n";
     }
 